@@ -0,0 +1,379 @@
+#ifndef BUREAUCRACY_BATCHINGWORKER_HPP
+#define BUREAUCRACY_BATCHINGWORKER_HPP 1
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <bureaucracy/timer.hpp>
+#include <bureaucracy/worker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+namespace bureaucracy
+{
+    /** \brief Collects values and hands them to a Worker in batches.
+     *
+     * A BatchingWorker gathers values into a batch and passes the whole
+     * batch to a Handler executed by another Worker.  A batch is flushed as
+     * soon as it holds a maximum number of values, or once a maximum delay
+     * has passed since its first value was added, whichever comes first.
+     * The delay is measured by a Timer, so no thread waits for it.
+     *
+     * Values are passed to the Handler in the order they were added.
+     * Batches are handed to the underlying Worker in order, but the Worker
+     * decides the order they execute in; use a SerialWorker if batches must
+     * be handled one at a time.
+     *
+     * \tparam T
+     *      the type of value being batched; it must be copyable
+     */
+    template <typename T>
+    class BatchingWorker
+    {
+    public:
+        /// \brief A batch of values.
+        using Batch = std::vector<T>;
+
+        /// \brief A function that processes a Batch.
+        using Handler = std::function<void(Batch)>;
+
+        /// \brief A measure of how long a batch can wait.
+        using Duration = Timer::Time::duration;
+
+        /** \brief Construct a BatchingWorker.
+         *
+         * \param [in] worker
+         *      the Worker that executes \p handler
+         *
+         * \param [in] timer
+         *      the Timer used to flush batches that aren't full
+         *
+         * \param [in] handler
+         *      the function to call with each Batch
+         *
+         * \param [in] maxItems
+         *      the number of values that causes a batch to be flushed
+         *
+         * \param [in] maxDelay
+         *      the longest a value waits before its batch is flushed
+         *
+         * \exception std::invalid_argument
+         *      \p maxItems is 0
+         *
+         * \warning \p timer must outlive this BatchingWorker.
+         */
+        BatchingWorker(Worker & worker, Timer & timer, Handler handler,
+                       std::size_t maxItems, Duration maxDelay);
+
+        /** \brief Add a value to the current batch.
+         *
+         * \param [in] value
+         *      the value to add
+         *
+         * \exception std::runtime_error
+         *      the BatchingWorker is not accepting values
+         */
+        void add(T value);
+
+        /** \brief Flush the current batch immediately, if it has any values.
+         */
+        void flush();
+
+        /** \brief Stop accepting values, flush the current batch, and wait
+         *         for every Batch to be handled.
+         */
+        void stop();
+
+        /** \brief Determine if this BatchingWorker is accepting new values.
+         *
+         * \retval true this BatchingWorker is accepting new values
+         * \retval false this BatchingWorker is not accepting new values
+         */
+        bool isAccepting() const noexcept;
+
+        /** \brief Determine if this BatchingWorker is running.
+         *
+         * \retval true this BatchingWorker is running
+         * \retval false this BatchingWorker is not running
+         */
+        bool isRunning() const noexcept;
+
+        /** \brief Retrieve the number of values that were dropped.
+         *
+         * A batch flushed by its delay or by stop is dropped if the
+         * underlying Worker rejects it.
+         *
+         * \return the number of values that never reached the Handler
+         */
+        std::uint64_t dropped() const noexcept;
+
+        /// \cond false
+        ~BatchingWorker() noexcept;
+        BatchingWorker(BatchingWorker const &) = delete;
+        BatchingWorker(BatchingWorker &&) noexcept = delete;
+        BatchingWorker & operator=(BatchingWorker const &) = delete;
+        BatchingWorker & operator=(BatchingWorker &&) = delete;
+        /// \endcond
+
+    private:
+        Batch takeBatch() noexcept;
+
+        void dispatch(Batch batch);
+
+        void fire(std::uint64_t generation);
+
+        void finished() noexcept;
+
+        Worker * const my_worker;
+        Timer * const my_timer;
+
+        Handler const my_handler;
+
+        std::size_t const my_maxItems;
+        Duration const my_maxDelay;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_idle;
+
+        Batch my_batch;
+
+        // Identifies the current batch so a late alarm can't flush a newer
+        // one.
+        std::uint64_t my_generation;
+        Timer::Item my_alarmItem;
+        bool my_isArmed;
+        std::size_t my_armedAlarms;
+        std::size_t my_outstanding;
+        std::uint64_t my_dropped;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    template <typename T>
+    inline BatchingWorker<T>::BatchingWorker(Worker & worker, Timer & timer,
+                                             Handler handler,
+                                             std::size_t maxItems,
+                                             Duration maxDelay)
+      : my_worker{&worker}
+      , my_timer{&timer}
+      , my_handler{std::move(handler)}
+      , my_maxItems{maxItems}
+      , my_maxDelay{maxDelay}
+      , my_generation{0}
+      , my_alarmItem{nullptr, 0}
+      , my_isArmed{false}
+      , my_armedAlarms{0}
+      , my_outstanding{0}
+      , my_dropped{0}
+      , my_isAccepting{true}
+      , my_isRunning{true}
+    {
+        if(maxItems == 0)
+        {
+            throw std::invalid_argument{"Invalid batch size"};
+        }
+        my_batch.reserve(maxItems);
+    }
+
+    /// \cond false
+    template <typename T>
+    inline BatchingWorker<T>::~BatchingWorker() noexcept
+    {
+        stop();
+    }
+    /// \endcond
+
+    template <typename T>
+    inline void BatchingWorker<T>::add(T value)
+    {
+        auto batch = houseguest::synchronize(my_mutex, [this, &value]() {
+            if(!my_isAccepting)
+            {
+                throw std::runtime_error{"Not accepting work"};
+            }
+            if(my_batch.empty() && (my_maxItems > 1))
+            {
+                // arm first so nothing changes if the Timer rejects it
+                auto const generation = my_generation;
+                my_alarmItem = my_timer->add(
+                    [this, generation]() { fire(generation); },
+                    my_timer->now() + my_maxDelay);
+                my_isArmed = true;
+                ++my_armedAlarms;
+            }
+            my_batch.emplace_back(std::move(value));
+            if(my_batch.size() < my_maxItems)
+            {
+                return Batch{};
+            }
+            return takeBatch();
+        });
+        if(!batch.empty())
+        {
+            dispatch(std::move(batch));
+        }
+    }
+
+    template <typename T>
+    inline void BatchingWorker<T>::flush()
+    {
+        auto batch =
+            houseguest::synchronize(my_mutex, [this]() { return takeBatch(); });
+        if(!batch.empty())
+        {
+            dispatch(std::move(batch));
+        }
+    }
+
+    template <typename T>
+    inline void BatchingWorker<T>::stop()
+    {
+        auto batch = houseguest::synchronize(my_mutex, [this]() {
+            if(my_isAccepting)
+            {
+                my_isAccepting = false;
+                return takeBatch();
+            }
+            return Batch{};
+        });
+        std::size_t dropped = 0;
+        if(!batch.empty())
+        {
+            auto const size = batch.size();
+            try
+            {
+                dispatch(std::move(batch));
+            }
+            catch(std::runtime_error const &)
+            {
+                // the underlying Worker stopped; there's nowhere to send it
+                dropped = size;
+            }
+        }
+        houseguest::synchronize_unique(my_mutex, [this, dropped](auto lock) {
+            my_dropped += dropped;
+            if(my_isRunning)
+            {
+                // Alarms that couldn't be cancelled are firing and hold a
+                // pointer to this BatchingWorker, so they have to finish too.
+                my_idle.wait(lock, [this]() {
+                    return (my_outstanding == 0) && (my_armedAlarms == 0);
+                });
+                my_isRunning = false;
+            }
+        });
+    }
+
+    template <typename T>
+    inline bool BatchingWorker<T>::isAccepting() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isAccepting; });
+    }
+
+    template <typename T>
+    inline bool BatchingWorker<T>::isRunning() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isRunning; });
+    }
+
+    template <typename T>
+    inline std::uint64_t BatchingWorker<T>::dropped() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_dropped; });
+    }
+
+    template <typename T>
+    inline typename BatchingWorker<T>::Batch
+    BatchingWorker<T>::takeBatch() noexcept
+    {
+        // should be locked
+        Batch ret;
+        if(my_batch.empty())
+        {
+            return ret;
+        }
+        if(my_isArmed)
+        {
+            if(my_timer->cancel(my_alarmItem) ==
+               Timer::Item::CancelStatus::cancelled)
+            {
+                --my_armedAlarms;
+            }
+            my_isArmed = false;
+        }
+        ++my_generation;
+        ret.swap(my_batch);
+        my_batch.reserve(my_maxItems);
+        ++my_outstanding;
+        return ret;
+    }
+
+    template <typename T>
+    inline void BatchingWorker<T>::dispatch(Batch batch)
+    {
+        try
+        {
+            my_worker->add([b = std::move(batch), this]() mutable {
+                my_handler(std::move(b));
+                finished();
+            });
+        }
+        catch(...)
+        {
+            finished();
+            throw;
+        }
+    }
+
+    template <typename T>
+    inline void BatchingWorker<T>::fire(std::uint64_t generation)
+    {
+        auto batch = houseguest::synchronize(my_mutex, [this, generation]() {
+            if(generation == my_generation)
+            {
+                // this alarm is being used up, so there's nothing to cancel
+                my_isArmed = false;
+                return takeBatch();
+            }
+            return Batch{};
+        });
+        std::size_t dropped = 0;
+        if(!batch.empty())
+        {
+            auto const size = batch.size();
+            try
+            {
+                dispatch(std::move(batch));
+            }
+            catch(std::runtime_error const &)
+            {
+                // the underlying Worker stopped; there's nowhere to send it
+                dropped = size;
+            }
+        }
+        houseguest::synchronize(my_mutex, [this, dropped]() {
+            my_dropped += dropped;
+            --my_armedAlarms;
+            my_idle.notify_all();
+        });
+    }
+
+    template <typename T>
+    inline void BatchingWorker<T>::finished() noexcept
+    {
+        houseguest::synchronize(my_mutex, [this]() {
+            --my_outstanding;
+            my_idle.notify_all();
+        });
+    }
+} // namespace bureaucracy
+
+#endif
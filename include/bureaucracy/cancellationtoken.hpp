@@ -0,0 +1,142 @@
+#ifndef BUREAUCRACY_CANCELLATIONTOKEN_HPP
+#define BUREAUCRACY_CANCELLATIONTOKEN_HPP 1
+
+#include <atomic>
+#include <memory>
+
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A read-only view of whether Work has been cancelled.
+     *
+     * A CancellationToken is handed out by a CancellationSource and can be
+     * attached to Work when it's added to a Threadpool or an
+     * ExpandingThreadpool.  Queued Work whose token has been cancelled is
+     * skipped instead of executed.  Work that's already running can poll
+     * isCancelled and stop early.
+     *
+     * Copying a CancellationToken is cheap and every copy observes the same
+     * CancellationSource.  A default-constructed CancellationToken is never
+     * cancelled.
+     */
+    class CancellationToken
+    {
+        friend class CancellationSource;
+
+    public:
+        /** \brief Construct a CancellationToken that's never cancelled.
+         */
+        CancellationToken() = default;
+
+        /** \brief Determine if this CancellationToken has been cancelled.
+         *
+         * \retval true the CancellationSource has been cancelled
+         * \retval false the CancellationSource has not been cancelled
+         */
+        bool isCancelled() const noexcept;
+
+    private:
+        explicit CancellationToken(
+            std::shared_ptr<std::atomic<bool> const> state) noexcept;
+
+        std::shared_ptr<std::atomic<bool> const> my_state;
+    };
+
+    /** \brief Cancels every CancellationToken it hands out.
+     *
+     * A single call to cancel is one atomic store no matter how many pieces
+     * of Work share the CancellationSource's tokens, so a large fan-out of
+     * Work can be revoked cheaply.  Cancellation can't be undone.
+     */
+    class CancellationSource
+    {
+    public:
+        /** \brief Construct a CancellationSource that isn't cancelled.
+         */
+        CancellationSource();
+
+        /** \brief Get a CancellationToken tied to this CancellationSource.
+         *
+         * \return a CancellationToken that's cancelled once cancel is called
+         */
+        CancellationToken token() const noexcept;
+
+        /** \brief Cancel every CancellationToken from this
+         *         CancellationSource.
+         */
+        void cancel() noexcept;
+
+        /** \brief Determine if this CancellationSource has been cancelled.
+         *
+         * \retval true cancel has been called
+         * \retval false cancel has not been called
+         */
+        bool isCancelled() const noexcept;
+
+    private:
+        std::shared_ptr<std::atomic<bool>> my_state;
+    };
+
+    /** \brief Wrap Work so it does nothing once \p token is cancelled.
+     *
+     * This gives any Worker (e.g., a SerialWorker) the ability to skip
+     * cancelled Work; the threadpools use it for Work added with a
+     * CancellationToken.  Cancelling doesn't remove the wrapped Work from a
+     * queue, so it (and anything it captured) is only released once the
+     * Worker reaches it.
+     *
+     * \param [in] work
+     *      the Work to wrap
+     *
+     * \param [in] token
+     *      the CancellationToken to check before executing \p work
+     *
+     * \return Work that executes \p work unless \p token is cancelled
+     */
+    Worker::Work withCancellation(Worker::Work work, CancellationToken token);
+
+    inline CancellationToken::CancellationToken(
+        std::shared_ptr<std::atomic<bool> const> state) noexcept
+      : my_state{std::move(state)}
+    {
+    }
+
+    inline bool CancellationToken::isCancelled() const noexcept
+    {
+        return my_state && my_state->load(std::memory_order_acquire);
+    }
+
+    inline CancellationSource::CancellationSource()
+      : my_state{std::make_shared<std::atomic<bool>>(false)}
+    {
+    }
+
+    inline CancellationToken CancellationSource::token() const noexcept
+    {
+        return CancellationToken{my_state};
+    }
+
+    inline void CancellationSource::cancel() noexcept
+    {
+        my_state->store(true, std::memory_order_release);
+    }
+
+    inline bool CancellationSource::isCancelled() const noexcept
+    {
+        return my_state->load(std::memory_order_acquire);
+    }
+
+    inline Worker::Work withCancellation(Worker::Work work,
+                                         CancellationToken token)
+    {
+        return [w = std::move(work), t = std::move(token)]() {
+            if(!t.isCancelled())
+            {
+                w();
+            }
+        };
+    }
+} // namespace bureaucracy
+
+#endif
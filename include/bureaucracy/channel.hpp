@@ -0,0 +1,665 @@
+#ifndef BUREAUCRACY_CHANNEL_HPP
+#define BUREAUCRACY_CHANNEL_HPP 1
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include <bureaucracy/worker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A bounded queue for passing values between threads.
+     *
+     * A Channel is a fixed-size ring buffer that any number of threads can
+     * push to and pop from at once.  Each slot carries a sequence number
+     * that tells producers and consumers whether it's free or full, so
+     * tryPush and tryPop never take a lock; contention costs one
+     * compare-and-swap.  The blocking and timed versions only fall back to a
+     * lock when they have to wait.
+     *
+     * Instead of dedicating a thread to popping, a Channel can be given a
+     * consumer: a Handler that's executed by a Worker whenever values
+     * arrive.  The consumer is only scheduled when the Channel goes from
+     * empty to non-empty, and it handles every available value before giving
+     * its thread back.
+     *
+     * Once closed, a Channel rejects new values but can still be drained.
+     *
+     * \tparam T
+     *      the type of value passed through the Channel; moving a T should
+     *      not throw
+     */
+    template <typename T>
+    class Channel
+    {
+    public:
+        /// \brief A function that consumes values from a Channel.
+        using Handler = std::function<void(T)>;
+
+        /// \brief A measure of how long to wait.
+        using Duration = std::chrono::steady_clock::duration;
+
+        /** \brief Construct a Channel.
+         *
+         * \param [in] capacity
+         *      the most values the Channel can hold; rounded up to a power
+         *      of two (and at least 2)
+         */
+        explicit Channel(std::size_t capacity);
+
+        /** \brief Push a value if there's room.
+         *
+         * \param [in] value
+         *      the value to push; it's only moved from if it was pushed
+         *
+         * \retval true \p value was pushed
+         * \retval false the Channel is full or closed
+         */
+        template <typename U>
+        bool tryPush(U && value);
+
+        /** \brief Push a value, waiting for room if the Channel is full.
+         *
+         * \param [in] value
+         *      the value to push
+         *
+         * \exception std::runtime_error
+         *      the Channel is closed
+         */
+        template <typename U>
+        void push(U && value);
+
+        /** \brief Push a value, waiting up to \p timeout for room.
+         *
+         * \param [in] value
+         *      the value to push; it's only moved from if it was pushed
+         *
+         * \param [in] timeout
+         *      the longest time to wait
+         *
+         * \retval true \p value was pushed
+         * \retval false the Channel stayed full or was closed
+         */
+        template <typename U>
+        bool tryPushFor(U && value, Duration timeout);
+
+        /** \brief Pop a value if one is available.
+         *
+         * \param [out] value
+         *      assigned the popped value
+         *
+         * \retval true a value was popped
+         * \retval false the Channel is empty
+         */
+        bool tryPop(T & value);
+
+        /** \brief Pop a value, waiting for one if the Channel is empty.
+         *
+         * \param [out] value
+         *      assigned the popped value
+         *
+         * \retval true a value was popped
+         * \retval false the Channel is closed and empty
+         */
+        bool pop(T & value);
+
+        /** \brief Pop a value, waiting up to \p timeout for one.
+         *
+         * \param [out] value
+         *      assigned the popped value
+         *
+         * \param [in] timeout
+         *      the longest time to wait
+         *
+         * \retval true a value was popped
+         * \retval false the Channel stayed empty
+         */
+        bool tryPopFor(T & value, Duration timeout);
+
+        /** \brief Execute \p handler on \p worker for each value pushed.
+         *
+         * Values already in the Channel are handled too.  Only one consumer
+         * runs at a time, so \p handler is never called concurrently and
+         * sees values in the order they were popped.  Values can still be
+         * popped directly, but they won't reach \p handler.  If \p handler
+         * throws, the value it was handling is discarded and the consumer
+         * moves on to the next one.
+         *
+         * \param [in] worker
+         *      the Worker that executes \p handler
+         *
+         * \param [in] handler
+         *      the function to call with each value
+         *
+         * \exception std::runtime_error
+         *      the Channel already has a consumer
+         */
+        void consume(Worker & worker, Handler handler);
+
+        /** \brief Detach the consumer, waiting for it to finish if it's
+         *         running.
+         *
+         * Values still in the Channel stay there.
+         */
+        void stopConsuming();
+
+        /** \brief Stop accepting values and wake any thread waiting in pop.
+         */
+        void close() noexcept;
+
+        /** \brief Determine if this Channel has been closed.
+         *
+         * \retval true the Channel is closed
+         * \retval false the Channel is open
+         */
+        bool isClosed() const noexcept;
+
+        /** \brief Retrieve an estimate of the number of values in the
+         *         Channel.
+         *
+         * \return the number of values in the Channel; this may be stale as
+         *         soon as it's returned
+         */
+        std::size_t size() const noexcept;
+
+        /** \brief Retrieve the number of values this Channel can hold.
+         *
+         * \return the capacity of the Channel
+         */
+        std::size_t capacity() const noexcept;
+
+        /// \cond false
+        ~Channel() noexcept;
+        Channel(Channel const &) = delete;
+        Channel(Channel &&) noexcept = delete;
+        Channel & operator=(Channel const &) = delete;
+        Channel & operator=(Channel &&) = delete;
+        /// \endcond
+
+    private:
+        struct Cell
+        {
+            // pos means free for the push at pos; pos + 1 means full for the
+            // pop at pos
+            std::atomic<std::size_t> sequence;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type item;
+        };
+
+        using Deadline = std::chrono::steady_clock::time_point;
+
+        static std::size_t roundCapacity(std::size_t capacity) noexcept;
+
+        static Deadline deadlineAfter(Duration timeout) noexcept;
+
+        static bool waitUntil(std::condition_variable & condition,
+                              std::unique_lock<std::mutex> & lock,
+                              Deadline deadline);
+
+        template <typename U>
+        bool pushUntil(U && value, Deadline deadline);
+
+        bool popUntil(T & value, Deadline deadline);
+
+        template <typename U>
+        bool enqueue(U && value);
+
+        template <typename SINK>
+        bool dequeue(SINK && sink);
+
+        void pushed();
+
+        void popped();
+
+        void scheduleConsumer() noexcept;
+
+        void drainConsumer() noexcept;
+
+        std::size_t const my_mask;
+        std::unique_ptr<Cell[]> const my_cells;
+
+        // producers and consumers each get their own cache line
+        alignas(64) std::atomic<std::size_t> my_enqueuePos;
+        alignas(64) std::atomic<std::size_t> my_dequeuePos;
+
+        alignas(64) std::atomic<std::size_t> my_pushWaiters;
+        std::atomic<std::size_t> my_popWaiters;
+        std::atomic<bool> my_isClosed;
+
+        std::atomic<bool> my_hasConsumer;
+        std::atomic<bool> my_isScheduled;
+        Worker * my_consumerWorker;
+        Handler my_handler;
+
+        std::mutex my_mutex;
+        std::condition_variable my_hasSpace;
+        std::condition_variable my_hasData;
+        std::condition_variable my_consumerIdle;
+    };
+
+    template <typename T>
+    inline Channel<T>::Channel(std::size_t capacity)
+      : my_mask{roundCapacity(capacity) - 1}
+      , my_cells{new Cell[my_mask + 1]}
+      , my_enqueuePos{0}
+      , my_dequeuePos{0}
+      , my_pushWaiters{0}
+      , my_popWaiters{0}
+      , my_isClosed{false}
+      , my_hasConsumer{false}
+      , my_isScheduled{false}
+      , my_consumerWorker{nullptr}
+    {
+        for(auto i = 0u; i <= my_mask; ++i)
+        {
+            my_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /// \cond false
+    template <typename T>
+    inline Channel<T>::~Channel() noexcept
+    {
+        close();
+        stopConsuming();
+        auto const end = my_enqueuePos.load();
+        for(auto pos = my_dequeuePos.load(); pos != end; ++pos)
+        {
+            reinterpret_cast<T *>(&my_cells[pos & my_mask].item)->~T();
+        }
+    }
+    /// \endcond
+
+    template <typename T>
+    template <typename U>
+    inline bool Channel<T>::tryPush(U && value)
+    {
+        if(my_isClosed.load(std::memory_order_acquire) ||
+           !enqueue(std::forward<U>(value)))
+        {
+            return false;
+        }
+        pushed();
+        return true;
+    }
+
+    template <typename T>
+    template <typename U>
+    inline void Channel<T>::push(U && value)
+    {
+        if(!pushUntil(std::forward<U>(value), Deadline::max()))
+        {
+            throw std::runtime_error{"Channel is closed"};
+        }
+    }
+
+    template <typename T>
+    template <typename U>
+    inline bool Channel<T>::tryPushFor(U && value, Duration timeout)
+    {
+        return pushUntil(std::forward<U>(value), deadlineAfter(timeout));
+    }
+
+    template <typename T>
+    inline bool Channel<T>::tryPop(T & value)
+    {
+        if(!dequeue([&value](T && item) { value = std::move(item); }))
+        {
+            return false;
+        }
+        popped();
+        return true;
+    }
+
+    template <typename T>
+    inline bool Channel<T>::pop(T & value)
+    {
+        return popUntil(value, Deadline::max());
+    }
+
+    template <typename T>
+    inline bool Channel<T>::tryPopFor(T & value, Duration timeout)
+    {
+        return popUntil(value, deadlineAfter(timeout));
+    }
+
+    template <typename T>
+    inline void Channel<T>::consume(Worker & worker, Handler handler)
+    {
+        houseguest::synchronize(my_mutex, [this, &worker, &handler]() {
+            if(my_hasConsumer)
+            {
+                throw std::runtime_error{"Channel already has a consumer"};
+            }
+            my_consumerWorker = &worker;
+            my_handler = std::move(handler);
+            my_hasConsumer = true;
+        });
+        // Pick up anything pushed before the consumer was attached.  A push
+        // that raced with attaching the consumer either shows up in size()
+        // here or sees my_hasConsumer in pushed.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if((size() != 0) && !my_isScheduled.exchange(true))
+        {
+            scheduleConsumer();
+        }
+    }
+
+    template <typename T>
+    inline void Channel<T>::stopConsuming()
+    {
+        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            if(my_hasConsumer)
+            {
+                my_hasConsumer = false;
+                my_consumerIdle.wait(lock,
+                                     [this]() { return !my_isScheduled; });
+                my_consumerWorker = nullptr;
+                my_handler = nullptr;
+            }
+        });
+    }
+
+    template <typename T>
+    inline void Channel<T>::close() noexcept
+    {
+        my_isClosed = true;
+        houseguest::synchronize(my_mutex, [this]() {
+            my_hasSpace.notify_all();
+            my_hasData.notify_all();
+        });
+    }
+
+    template <typename T>
+    inline bool Channel<T>::isClosed() const noexcept
+    {
+        return my_isClosed;
+    }
+
+    template <typename T>
+    inline std::size_t Channel<T>::size() const noexcept
+    {
+        auto const dequeuePos = my_dequeuePos.load();
+        auto const enqueuePos = my_enqueuePos.load();
+        // the positions are read separately, so a pop can appear to have
+        // passed a push
+        return (enqueuePos > dequeuePos) ? (enqueuePos - dequeuePos) : 0;
+    }
+
+    template <typename T>
+    inline std::size_t Channel<T>::capacity() const noexcept
+    {
+        return my_mask + 1;
+    }
+
+    template <typename T>
+    inline std::size_t Channel<T>::roundCapacity(std::size_t capacity) noexcept
+    {
+        std::size_t ret = 2;
+        while(ret < capacity)
+        {
+            ret <<= 1;
+        }
+        return ret;
+    }
+
+    template <typename T>
+    inline typename Channel<T>::Deadline
+    Channel<T>::deadlineAfter(Duration timeout) noexcept
+    {
+        auto const now = std::chrono::steady_clock::now();
+        return (timeout < Deadline::max() - now) ? now + timeout
+                                                 : Deadline::max();
+    }
+
+    template <typename T>
+    inline bool Channel<T>::waitUntil(std::condition_variable & condition,
+                                      std::unique_lock<std::mutex> & lock,
+                                      Deadline deadline)
+    {
+        if(deadline == Deadline::max())
+        {
+            condition.wait(lock);
+            return true;
+        }
+        return condition.wait_until(lock, deadline) != std::cv_status::timeout;
+    }
+
+    template <typename T>
+    template <typename U>
+    inline bool Channel<T>::pushUntil(U && value, Deadline deadline)
+    {
+        if(tryPush(std::forward<U>(value)))
+        {
+            return true;
+        }
+        auto const ret = houseguest::synchronize_unique(
+            my_mutex, [this, &value, deadline](auto lock) {
+                // Announce the wait before retrying, so a pop that frees a
+                // cell after the retry fails knows to wake this thread.
+                ++my_pushWaiters;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto isPushed = false;
+                while(!my_isClosed &&
+                      !(isPushed = enqueue(std::forward<U>(value))) &&
+                      waitUntil(my_hasSpace, lock, deadline))
+                {
+                }
+                --my_pushWaiters;
+                return isPushed;
+            });
+        if(ret)
+        {
+            // notifying takes my_mutex, so it waits until it's released
+            pushed();
+        }
+        return ret;
+    }
+
+    template <typename T>
+    inline bool Channel<T>::popUntil(T & value, Deadline deadline)
+    {
+        if(tryPop(value))
+        {
+            return true;
+        }
+        auto const ret = houseguest::synchronize_unique(
+            my_mutex, [this, &value, deadline](auto lock) {
+                ++my_popWaiters;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                auto isPopped = false;
+                // A closed Channel can still have a push in progress, so
+                // keep waiting until it's actually empty.
+                while(!(isPopped = dequeue([&value](T && item) {
+                            value = std::move(item);
+                        })) &&
+                      !(my_isClosed && (size() == 0)) &&
+                      waitUntil(my_hasData, lock, deadline))
+                {
+                }
+                --my_popWaiters;
+                return isPopped;
+            });
+        if(ret)
+        {
+            popped();
+        }
+        return ret;
+    }
+
+    template <typename T>
+    template <typename U>
+    inline bool Channel<T>::enqueue(U && value)
+    {
+        auto pos = my_enqueuePos.load(std::memory_order_relaxed);
+        Cell * cell;
+        while(true)
+        {
+            cell = &my_cells[pos & my_mask];
+            auto const sequence =
+                cell->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(pos);
+            if(diff == 0)
+            {
+                if(my_enqueuePos.compare_exchange_weak(
+                       pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(diff < 0)
+            {
+                // the slot still holds a value from the last lap; full
+                return false;
+            }
+            else
+            {
+                pos = my_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new(&cell->item) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    template <typename T>
+    template <typename SINK>
+    inline bool Channel<T>::dequeue(SINK && sink)
+    {
+        auto pos = my_dequeuePos.load(std::memory_order_relaxed);
+        Cell * cell;
+        while(true)
+        {
+            cell = &my_cells[pos & my_mask];
+            auto const sequence =
+                cell->sequence.load(std::memory_order_acquire);
+            auto const diff = static_cast<std::intptr_t>(sequence) -
+                              static_cast<std::intptr_t>(pos + 1);
+            if(diff == 0)
+            {
+                if(my_dequeuePos.compare_exchange_weak(
+                       pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if(diff < 0)
+            {
+                // nothing has been pushed to this slot yet; empty
+                return false;
+            }
+            else
+            {
+                pos = my_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        auto item = reinterpret_cast<T *>(&cell->item);
+        T value{std::move(*item)};
+        item->~T();
+        // free the slot before handing the value off
+        cell->sequence.store(pos + my_mask + 1, std::memory_order_release);
+        sink(std::move(value));
+        return true;
+    }
+
+    template <typename T>
+    inline void Channel<T>::pushed()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(my_popWaiters.load(std::memory_order_relaxed) != 0)
+        {
+            houseguest::synchronize(my_mutex,
+                                    [this]() { my_hasData.notify_all(); });
+        }
+        if(my_hasConsumer.load(std::memory_order_relaxed) &&
+           !my_isScheduled.exchange(true))
+        {
+            scheduleConsumer();
+        }
+    }
+
+    template <typename T>
+    inline void Channel<T>::popped()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(my_pushWaiters.load(std::memory_order_relaxed) != 0)
+        {
+            houseguest::synchronize(my_mutex,
+                                    [this]() { my_hasSpace.notify_all(); });
+        }
+    }
+
+    template <typename T>
+    inline void Channel<T>::scheduleConsumer() noexcept
+    {
+        // my_isScheduled has been set by the caller
+        houseguest::synchronize(my_mutex, [this]() {
+            if(my_hasConsumer)
+            {
+                try
+                {
+                    my_consumerWorker->add([this]() { drainConsumer(); });
+                    return;
+                }
+                catch(...)
+                {
+                    // the Worker stopped; values stay in the Channel
+                }
+            }
+            my_isScheduled = false;
+            my_consumerIdle.notify_all();
+        });
+    }
+
+    template <typename T>
+    inline void Channel<T>::drainConsumer() noexcept
+    {
+        // free the slot (and wake blocked pushers) before handling a value
+        while(dequeue([this](T && value) {
+            popped();
+            try
+            {
+                my_handler(std::move(value));
+            }
+            catch(...)
+            {
+                // there's nobody to report to; move on to the next value
+            }
+        }))
+        {
+        }
+        houseguest::synchronize(my_mutex, [this]() {
+            // A value pushed after the last dequeue either shows up in
+            // size() below or finds my_isScheduled clear and schedules a
+            // new drain itself.
+            my_isScheduled = false;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(my_hasConsumer && (size() != 0) &&
+               !my_isScheduled.exchange(true))
+            {
+                try
+                {
+                    my_consumerWorker->add([this]() { drainConsumer(); });
+                    return;
+                }
+                catch(...)
+                {
+                    my_isScheduled = false;
+                }
+            }
+            my_consumerIdle.notify_all();
+        });
+    }
+} // namespace bureaucracy
+
+#endif
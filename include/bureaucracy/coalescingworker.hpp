@@ -0,0 +1,281 @@
+#ifndef BUREAUCRACY_COALESCINGWORKER_HPP
+#define BUREAUCRACY_COALESCINGWORKER_HPP 1
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <bureaucracy/worker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that keeps at most one piece of pending Work per key.
+     *
+     * Work added to a CoalescingWorker with a key replaces any Work for the
+     * same key that hasn't started yet, so a burst of identical requests
+     * (e.g., "refresh cache entry X") runs once instead of once per request.
+     * The most recently added Work is the one that runs.  The cost of a
+     * burst is proportional to the number of distinct keys rather than the
+     * number of requests.
+     *
+     * Once a key's Work starts, Work added for that key is scheduled again,
+     * so nothing added after Work starts is lost.  Work for different keys
+     * (and Work for the same key in different rounds) can run in parallel
+     * depending on the underlying Worker.
+     *
+     * \tparam KEY
+     *      the type used to identify Work that can be coalesced
+     *
+     * \tparam HASH
+     *      a function object that hashes a KEY
+     *
+     * \tparam EQUAL
+     *      a function object that compares two KEYs for equality
+     */
+    template <typename KEY, typename HASH = std::hash<KEY>,
+              typename EQUAL = std::equal_to<KEY>>
+    class CoalescingWorker : public Worker
+    {
+    public:
+        /// \brief The type used to identify Work that can be coalesced.
+        using Key = KEY;
+
+        /** \brief Construct a CoalescingWorker.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit CoalescingWorker(Worker & worker);
+
+        /** \brief Queue Work for a key, replacing any pending Work for it.
+         *
+         * \param [in] key
+         *      the key \p work is coalesced by
+         *
+         * \param [in] work
+         *      a function that will be called at a later time
+         *
+         * \exception std::runtime_error
+         *      the CoalescingWorker is not accepting Work
+         *
+         * \note If the underlying Worker rejects the Work, whatever is
+         *       pending for \p key is discarded and its exception is
+         *       propagated.
+         */
+        void add(Key const & key, Work work);
+
+        /** \brief Queue Work that doesn't belong to any key.
+         *
+         * \p work is passed straight to the underlying Worker and is never
+         * coalesced.  stop still waits for it to complete.
+         */
+        void add(Work work) override;
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /** \brief Retrieve the number of keys with Work waiting to start.
+         *
+         * \return the number of keys with pending Work
+         */
+        std::size_t pendingKeys() const noexcept;
+
+        /** \brief Retrieve the number of pieces of Work that were replaced
+         *         before they started.
+         *
+         * \return the number of pieces of Work coalesced away
+         */
+        std::uint64_t coalesced() const noexcept;
+
+        /// \cond false
+        ~CoalescingWorker() noexcept override;
+        CoalescingWorker(CoalescingWorker const &) = delete;
+        CoalescingWorker(CoalescingWorker &&) noexcept = delete;
+        CoalescingWorker & operator=(CoalescingWorker const &) = delete;
+        CoalescingWorker & operator=(CoalescingWorker &&) = delete;
+        /// \endcond
+
+    private:
+        void runPending(Key const & key) noexcept;
+
+        void finished() noexcept;
+
+        Worker * const my_worker;
+
+        // A key is only present while its Work is scheduled but not started.
+        std::unordered_map<Key, Work, HASH, EQUAL> my_pending;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_isEmpty;
+
+        std::size_t my_outstanding;
+        std::uint64_t my_coalesced;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline CoalescingWorker<KEY, HASH, EQUAL>::CoalescingWorker(
+        Worker & worker)
+      : my_worker{&worker}
+      , my_outstanding{0}
+      , my_coalesced{0}
+      , my_isAccepting{true}
+      , my_isRunning{true}
+    {
+    }
+
+    /// \cond false
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline CoalescingWorker<KEY, HASH, EQUAL>::~CoalescingWorker() noexcept
+    {
+        CoalescingWorker::stop();
+    }
+    /// \endcond
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void CoalescingWorker<KEY, HASH, EQUAL>::add(Key const & key,
+                                                       Work work)
+    {
+        auto const schedule =
+            houseguest::synchronize(my_mutex, [this, &key, &work]() {
+                if(!my_isAccepting)
+                {
+                    throw std::runtime_error{"Not accepting work"};
+                }
+                auto it = my_pending.find(key);
+                if(it != std::end(my_pending))
+                {
+                    // already scheduled; the newer Work runs instead
+                    it->second = std::move(work);
+                    ++my_coalesced;
+                    return false;
+                }
+                my_pending.emplace(key, std::move(work));
+                ++my_outstanding;
+                return true;
+            });
+
+        if(schedule)
+        {
+            try
+            {
+                my_worker->add([this, key]() { runPending(key); });
+            }
+            catch(...)
+            {
+                houseguest::synchronize(
+                    my_mutex, [this, &key]() { my_pending.erase(key); });
+                finished();
+                throw;
+            }
+        }
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void CoalescingWorker<KEY, HASH, EQUAL>::add(Work work)
+    {
+        houseguest::synchronize(my_mutex, [this]() {
+            if(!my_isAccepting)
+            {
+                throw std::runtime_error{"Not accepting work"};
+            }
+            ++my_outstanding;
+        });
+        try
+        {
+            my_worker->add([w = std::move(work), this]() {
+                w();
+                finished();
+            });
+        }
+        catch(...)
+        {
+            finished();
+            throw;
+        }
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void CoalescingWorker<KEY, HASH, EQUAL>::stop()
+    {
+        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            if(my_isAccepting)
+            {
+                my_isAccepting = false;
+                my_isEmpty.wait(lock,
+                                [this]() { return my_outstanding == 0; });
+                my_isRunning = false;
+            }
+        });
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline bool CoalescingWorker<KEY, HASH, EQUAL>::isAccepting() const
+        noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isAccepting; });
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline bool CoalescingWorker<KEY, HASH, EQUAL>::isRunning() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isRunning; });
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline std::size_t CoalescingWorker<KEY, HASH, EQUAL>::pendingKeys() const
+        noexcept
+    {
+        return houseguest::synchronize(
+            my_mutex, [this]() { return my_pending.size(); });
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline std::uint64_t CoalescingWorker<KEY, HASH, EQUAL>::coalesced() const
+        noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_coalesced; });
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void
+    CoalescingWorker<KEY, HASH, EQUAL>::runPending(Key const & key) noexcept
+    {
+        // Removing the key first means Work added while this runs gets a
+        // round of its own.
+        auto work = houseguest::synchronize(my_mutex, [this, &key]() {
+            auto it = my_pending.find(key);
+            auto ret = std::move(it->second);
+            my_pending.erase(it);
+            return ret;
+        });
+        work();
+        finished();
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void CoalescingWorker<KEY, HASH, EQUAL>::finished() noexcept
+    {
+        houseguest::synchronize(my_mutex, [this]() {
+            if(--my_outstanding == 0)
+            {
+                my_isEmpty.notify_all();
+            }
+        });
+    }
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef BUREAUCRACY_DEADLINEWORKER_HPP
+#define BUREAUCRACY_DEADLINEWORKER_HPP 1
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <bureaucracy/diligentworker.hpp>
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that drops Work whose deadline has passed.
+     *
+     * A DeadlineWorker lets each piece of Work carry a Deadline.  When the
+     * underlying Worker gets around to the Work the Deadline is checked; if
+     * it has passed the Work is dropped (or replaced with a fallback
+     * provided when it was added) instead of executed.  Under overload this
+     * sheds Work nobody is waiting for anymore rather than letting the
+     * backlog grow.  The number of pieces of Work dropped is available from
+     * dropped.
+     *
+     * Work added without a Deadline is never dropped.
+     *
+     * \note DeadlineWorker reads the clock once for each piece of Work with
+     *       a Deadline, and tracks outstanding Work with a DiligentWorker.
+     */
+    class DeadlineWorker : public Worker
+    {
+    public:
+        /// \brief The clock used to check Deadlines.
+        using Clock = std::chrono::steady_clock;
+
+        /// \brief The latest time Work can start.
+        using Deadline = Clock::time_point;
+
+        /** \brief Construct a DeadlineWorker
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit DeadlineWorker(Worker & worker);
+
+        void add(Work work) override;
+
+        /** \brief Add Work that's dropped if it can't start by \p deadline.
+         *
+         * \param [in] work
+         *      the Work to perform
+         *
+         * \param [in] deadline
+         *      the latest time \p work can start
+         *
+         * \exception std::runtime_error
+         *      the DeadlineWorker is not accepting work
+         */
+        void add(Work work, Deadline deadline);
+
+        /** \brief Add Work that's replaced with \p onExpired if it can't
+         *         start by \p deadline.
+         *
+         * \p onExpired is executed by the underlying Worker in place of \p
+         * work, so callers can be told their Work was dropped (e.g., by
+         * failing a promise).  It should be cheap.
+         *
+         * \param [in] work
+         *      the Work to perform
+         *
+         * \param [in] deadline
+         *      the latest time \p work can start
+         *
+         * \param [in] onExpired
+         *      Work to perform instead of \p work if \p deadline has passed
+         *
+         * \exception std::runtime_error
+         *      the DeadlineWorker is not accepting work
+         */
+        void add(Work work, Deadline deadline, Work onExpired);
+
+        /** \brief Get the number of pieces of Work dropped because their
+         *         Deadline passed.
+         *
+         * \return the number of pieces of Work dropped
+         */
+        std::uint64_t dropped() const noexcept;
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~DeadlineWorker() noexcept override;
+        /// \endcond
+
+    private:
+        // stop waits for the DiligentWorker to go idle, so it's safe to touch
+        // my_dropped from Work
+        DiligentWorker my_worker;
+
+        std::atomic<std::uint64_t> my_dropped;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef BUREAUCRACY_DELAYEDWORKER_HPP
+#define BUREAUCRACY_DELAYEDWORKER_HPP 1
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <bureaucracy/timer.hpp>
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that can hold Work until a later time.
+     *
+     * A DelayedWorker feeds Work to another Worker.  Work added with add is
+     * forwarded immediately; Work added with addAt or addAfter is held until
+     * it's due.  The DelayedWorker keeps a single Event armed in a Timer for
+     * the earliest delayed Work, and when it fires every piece of Work that
+     * has come due is handed to the underlying Worker.
+     *
+     * Work is handed over in the order it was due; Work due at the same time
+     * is handed over in the order it was added.  Each piece of Work is added
+     * to the underlying Worker separately, so use a SerialWorker if Work
+     * must also be executed in that order.
+     */
+    class DelayedWorker : public Worker
+    {
+    public:
+        /// \brief A point in time when Work can be executed.
+        using Time = Timer::Time;
+
+        /// \brief Work added to a DelayedWorker with a delay.
+        class Item
+        {
+            friend class DelayedWorker;
+
+        public:
+            /// \brief An Identifier for an Item.
+            using Id = std::uint64_t;
+
+            /** \brief Construct an Item.
+             *
+             * \internal
+             *
+             * \param [in] due
+             *      the time the Work is due
+             *
+             * \param [in] id
+             *      the Id of this Item
+             */
+            Item(Time due, Id id);
+
+        private:
+            Time my_due;
+            Id my_id;
+        };
+
+        /** \brief Construct a DelayedWorker.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] timer
+         *      the Timer used to wait for delayed Work
+         *
+         * \warning \p timer must outlive this DelayedWorker.
+         */
+        DelayedWorker(Worker & worker, Timer & timer);
+
+        /** \brief Forward Work to the underlying Worker immediately.
+         *
+         * \param [in] work
+         *      a piece of Work
+         *
+         * \exception std::runtime_error
+         *      the DelayedWorker is not accepting Work
+         */
+        void add(Work work) override;
+
+        /** \brief Add Work that will be executed at a specific time.
+         *
+         * \param [in] work
+         *      a piece of Work
+         *
+         * \param [in] due
+         *      an exact (not relative) time to hand \p work to the
+         *      underlying Worker
+         *
+         * \return an Item that can be used to cancel \p work
+         *
+         * \exception std::runtime_error
+         *      the DelayedWorker is not accepting Work
+         *
+         * \note If \p due is not in the future \p work is forwarded
+         *       immediately and can no longer be cancelled.
+         */
+        Item addAt(Work work, Time due);
+
+        /** \brief Add Work that will be executed after a delay.
+         *
+         * This is equivalent to calling addAt with `now() + delay`, where
+         * `now()` comes from the Timer's clock.
+         *
+         * \param [in] work
+         *      a piece of Work
+         *
+         * \param [in] delay
+         *      a duration to wait
+         *
+         * \return an Item that can be used to cancel \p work
+         *
+         * \exception std::runtime_error
+         *      the DelayedWorker is not accepting Work
+         */
+        template <typename... ARGS>
+        Item addAfter(Work work, std::chrono::duration<ARGS...> delay);
+
+        /** \brief Cancel delayed Work if possible.
+         *
+         * \retval Timer::Item::CancelStatus::cancelled
+         *      The Work was cancelled and will never be executed.
+         *
+         * \retval Timer::Item::CancelStatus::failed
+         *      The Work has already been handed to the underlying Worker or
+         *      was already cancelled.
+         */
+        Timer::Item::CancelStatus cancel(Item item);
+
+        /** \brief Stop accepting Work and wait for forwarded Work to
+         *         complete.
+         *
+         * \note Delayed Work that hasn't come due will _not_ be executed.
+         */
+        void stop() override;
+
+        /** \brief Retrieve the number of pieces of delayed Work that were
+         *         dropped.
+         *
+         * Delayed Work is dropped if the underlying Worker rejects it when
+         * it comes due.
+         *
+         * \return the number of pieces of delayed Work that were never
+         *      executed
+         */
+        std::size_t dropped() const noexcept;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~DelayedWorker() noexcept override;
+        DelayedWorker(DelayedWorker const &) = delete;
+        DelayedWorker(DelayedWorker &&) noexcept = delete;
+        DelayedWorker & operator=(DelayedWorker const &) = delete;
+        DelayedWorker & operator=(DelayedWorker &&) = delete;
+        /// \endcond
+
+    private:
+        void arm(Time due);
+
+        void fire(std::uint64_t alarm);
+
+        void finished() noexcept;
+
+        Worker * const my_worker;
+        Timer * const my_timer;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_idle;
+
+        using Key = std::pair<Time, Item::Id>;
+        std::map<Key, Work> my_delayed;
+
+        Timer::Item my_alarmItem;
+        Time my_alarmDue;
+        std::uint64_t my_alarm;
+        std::size_t my_armedAlarms;
+        std::size_t my_outstanding;
+        std::size_t my_dropped;
+
+        Item::Id my_nextId;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    template <typename... ARGS>
+    inline DelayedWorker::Item
+    DelayedWorker::addAfter(Work work, std::chrono::duration<ARGS...> delay)
+    {
+        return addAt(std::move(work), my_timer->now() + delay);
+    }
+} // namespace bureaucracy
+
+#endif
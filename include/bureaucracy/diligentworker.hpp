@@ -1,8 +1,12 @@
 #ifndef WORKER_DILIGENTWORKER_HPP
 #define WORKER_DILIGENTWORKER_HPP 1
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
 #include <bureaucracy/worker.hpp>
-#include <bureaucracy/workercommon.hpp>
 
 namespace bureaucracy
 {
@@ -12,10 +16,10 @@ namespace bureaucracy
      * depleted.  It offers no guarantees about execution order or completion,
      * deferring those details to another Worker.
      *
-     * \note DiligentWorker requires checking whether all Work is completed
-     *       after each piece of Work completes.  This adds a slight
-     *       performance penalty to each piece of Work processed by a
-     *       DiligentWorker.
+     * \note DiligentWorker keeps an atomic count of outstanding Work, which
+     *       adds a slight performance penalty to each piece of Work it
+     *       processes.  A lock is only taken when the DiligentWorker goes
+     *       from idle to busy or back.
      */
     class DiligentWorker : public Worker
     {
@@ -41,6 +45,27 @@ namespace bureaucracy
 
         void add(Work work) override;
 
+        /** \brief Wait until all Work is complete.
+         *
+         * Block until there is no outstanding Work and the Alert for the
+         * most recent piece of Work has returned.  Work added while waiting
+         * is waited for too.
+         */
+        void waitIdle();
+
+        /** \brief Wait until all Work is complete, with a timeout.
+         *
+         * \param [in] timeout
+         *      the longest time to wait
+         *
+         * \retval true all Work completed
+         * \retval false \p timeout expired first
+         *
+         * \see waitIdle
+         */
+        template <typename... ARGS>
+        bool waitIdleFor(std::chrono::duration<ARGS...> timeout);
+
         void stop() override;
 
         bool isAccepting() const noexcept override;
@@ -52,10 +77,34 @@ namespace bureaucracy
         /// \endcond
 
     private:
-        WorkerCommon<int> my_worker;
+        void finished(bool alert) noexcept;
+
+        bool isIdle() const noexcept;
+
+        Worker * const my_worker;
 
         Alert my_alert;
+
+        std::atomic<std::size_t> my_outstanding;
+        std::atomic<bool> my_isAccepting;
+        std::atomic<bool> my_isRunning;
+
+        // Periods between the outstanding count leaving 0 and its Alert
+        // returning.  This can briefly be -1 if a period ends before the
+        // thread that started it records the start.
+        int my_busyPeriods;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_isIdle;
     };
+
+    template <typename... ARGS>
+    inline bool
+    DiligentWorker::waitIdleFor(std::chrono::duration<ARGS...> timeout)
+    {
+        std::unique_lock<std::mutex> lock{my_mutex};
+        return my_isIdle.wait_for(lock, timeout, [this]() { return isIdle(); });
+    }
 } // namespace bureaucracy
 
 #endif
@@ -1,6 +1,7 @@
 #ifndef BUREAUCRACY_EXPANDINTHREADPOOL_HPP
 #define BUREAUCRACY_EXPANDINTHREADPOOL_HPP 1
 
+#include <bureaucracy/cancellationtoken.hpp>
 #include <bureaucracy/threadpoolbase.hpp>
 #include <bureaucracy/worker.hpp>
 
@@ -55,6 +56,28 @@ namespace bureaucracy
          */
         void add(Work work) override;
 
+        /** \brief Add Work that can be cancelled while it's queued
+         *
+         * This behaves like the single-argument add, except \p work is
+         * skipped instead of executed if \p token is cancelled before a
+         * thread reaches it.  Cancelled Work stays queued until then, so it
+         * still counts as queued Work when deciding whether to spawn a
+         * thread.
+         *
+         * \param [in] work
+         *      a piece of Work
+         *
+         * \param [in] token
+         *      the CancellationToken that can revoke \p work
+         *
+         * \exception std::runtime_error
+         *      the ExpandingThreadpool is not accepting Work
+         *
+         * \exception std::exception
+         *      an exception was emitted by the standard library
+         */
+        void add(Work work, CancellationToken token);
+
         void stop() override;
 
         bool isAccepting() const noexcept override;
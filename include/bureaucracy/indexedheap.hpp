@@ -0,0 +1,126 @@
+#ifndef BUREAUCRACY_INDEXEDHEAP_HPP
+#define BUREAUCRACY_INDEXEDHEAP_HPP 1
+
+#include <algorithm>
+#include <cstddef>
+
+namespace bureaucracy
+{
+    template <std::size_t ARITY, typename EARLIER>
+    /** \internal
+     *
+     * IndexedHeap maintains an ARITY-ary min-heap stored in a random access
+     * container.  Each node points at an entry that records where the node
+     * is (`node.entry->index`), so a node can be removed or moved from the
+     * middle of the heap.  EARLIER is a default constructible function
+     * object that returns true if its first node belongs closer to the top.
+     * There are no guarantees about functionality.
+     *
+     * \cond false
+     */
+    class IndexedHeap
+    {
+    public:
+        static_assert(ARITY > 1, "A heap needs at least two children");
+
+        template <typename HEAP>
+        static void siftUp(HEAP & heap, std::size_t index) noexcept;
+
+        template <typename HEAP>
+        static void siftDown(HEAP & heap, std::size_t index) noexcept;
+
+        template <typename HEAP>
+        static void removeAt(HEAP & heap, std::size_t index) noexcept;
+
+    private:
+        template <typename HEAP>
+        static void place(HEAP & heap, std::size_t index,
+                          typename HEAP::value_type node) noexcept;
+    };
+
+    template <std::size_t ARITY, typename EARLIER>
+    template <typename HEAP>
+    inline void IndexedHeap<ARITY, EARLIER>::siftUp(HEAP & heap,
+                                                   std::size_t index) noexcept
+    {
+        EARLIER const isEarlier{};
+        auto const node = heap[index];
+        while(index > 0)
+        {
+            auto const parent = (index - 1) / ARITY;
+            if(!isEarlier(node, heap[parent]))
+            {
+                break;
+            }
+            place(heap, index, heap[parent]);
+            index = parent;
+        }
+        place(heap, index, node);
+    }
+
+    template <std::size_t ARITY, typename EARLIER>
+    template <typename HEAP>
+    inline void IndexedHeap<ARITY, EARLIER>::siftDown(HEAP & heap,
+                                                     std::size_t index) noexcept
+    {
+        EARLIER const isEarlier{};
+        auto const node = heap[index];
+        auto const size = heap.size();
+        while(true)
+        {
+            auto const first = (index * ARITY) + 1;
+            if(first >= size)
+            {
+                break;
+            }
+            auto const last = std::min(first + ARITY, size);
+            auto best = first;
+            for(auto child = first + 1; child < last; ++child)
+            {
+                if(isEarlier(heap[child], heap[best]))
+                {
+                    best = child;
+                }
+            }
+            if(!isEarlier(heap[best], node))
+            {
+                break;
+            }
+            place(heap, index, heap[best]);
+            index = best;
+        }
+        place(heap, index, node);
+    }
+
+    template <std::size_t ARITY, typename EARLIER>
+    template <typename HEAP>
+    inline void IndexedHeap<ARITY, EARLIER>::removeAt(HEAP & heap,
+                                                     std::size_t index) noexcept
+    {
+        auto const last = heap.size() - 1;
+        if(index != last)
+        {
+            place(heap, index, heap[last]);
+            heap.pop_back();
+            siftDown(heap, index);
+            siftUp(heap, index);
+        }
+        else
+        {
+            heap.pop_back();
+        }
+    }
+
+    template <std::size_t ARITY, typename EARLIER>
+    template <typename HEAP>
+    inline void
+    IndexedHeap<ARITY, EARLIER>::place(HEAP & heap, std::size_t index,
+                                       typename HEAP::value_type node) noexcept
+    {
+        node.entry->index = index;
+        heap[index] = node;
+    }
+    /// \endcond
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef BUREAUCRACY_KEYEDSERIALWORKER_HPP
+#define BUREAUCRACY_KEYEDSERIALWORKER_HPP 1
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <bureaucracy/worker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that serializes Work per key.
+     *
+     * A KeyedSerialWorker behaves like a collection of SerialWorkers, one for
+     * each key, that share an underlying Worker.  Work added with the same
+     * key is executed in the order it was added and never concurrently; Work
+     * with different keys can run in parallel.
+     *
+     * A key's queue (its strand) is created when Work is added for that key
+     * and reclaimed as soon as it drains, so memory use is proportional to
+     * the number of keys with outstanding Work rather than every key ever
+     * seen.  Strands are kept in several independently locked shards so
+     * unrelated keys rarely contend with each other.
+     *
+     * \tparam KEY
+     *      the type used to identify a strand
+     *
+     * \tparam HASH
+     *      a function object that hashes a KEY
+     *
+     * \tparam EQUAL
+     *      a function object that compares two KEYs for equality
+     *
+     * \warning Like a SerialWorker, a busy key can occupy a thread in the
+     *          underlying Worker for as long as it has Work queued.
+     */
+    template <typename KEY, typename HASH = std::hash<KEY>,
+              typename EQUAL = std::equal_to<KEY>>
+    class KeyedSerialWorker : public Worker
+    {
+    public:
+        /// \brief The type used to identify a strand.
+        using Key = KEY;
+
+        /** \brief Construct a KeyedSerialWorker.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit KeyedSerialWorker(Worker & worker);
+
+        /** \brief Construct a KeyedSerialWorker.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] shards
+         *      the number of independently locked maps to spread keys across
+         *
+         * \exception std::invalid_argument
+         *      \p shards is 0
+         */
+        KeyedSerialWorker(Worker & worker, std::size_t shards);
+
+        /** \brief Queue Work for a key.
+         *
+         * \p work is executed after any Work previously added for \p key.
+         *
+         * \param [in] key
+         *      the strand \p work belongs to
+         *
+         * \param [in] work
+         *      a function that will be called at a later time
+         *
+         * \exception std::runtime_error
+         *      the KeyedSerialWorker is not accepting Work
+         *
+         * \note If the underlying Worker rejects the strand, anything queued
+         *       for \p key is discarded and its exception is propagated.
+         */
+        void add(Key const & key, Work work);
+
+        /** \brief Queue Work that doesn't belong to any key.
+         *
+         * \p work is passed straight to the underlying Worker, so it has no
+         * ordering guarantees.  stop still waits for it to complete.
+         */
+        void add(Work work) override;
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /** \brief Retrieve the number of keys with outstanding Work.
+         *
+         * Each piece of Work added without a key counts as a strand of its
+         * own until it completes.
+         *
+         * \return the number of strands that are queued or running
+         */
+        std::size_t activeKeys() const noexcept;
+
+        /// \cond false
+        ~KeyedSerialWorker() noexcept override;
+        KeyedSerialWorker(KeyedSerialWorker const &) = delete;
+        KeyedSerialWorker(KeyedSerialWorker &&) noexcept = delete;
+        KeyedSerialWorker & operator=(KeyedSerialWorker const &) = delete;
+        KeyedSerialWorker & operator=(KeyedSerialWorker &&) = delete;
+        /// \endcond
+
+    private:
+        using WorkQueue = std::vector<Work>;
+
+        using StrandMap = std::unordered_map<Key, WorkQueue, HASH, EQUAL>;
+
+        struct Shard
+        {
+            std::mutex mutex;
+
+            // A key is only present while its strand is scheduled or running.
+            StrandMap strands;
+        };
+
+        Shard & shardFor(Key const & key) const noexcept;
+
+        void drain(Shard & shard,
+                   typename StrandMap::value_type & strand) noexcept;
+
+        void finished() noexcept;
+
+        Worker * const my_worker;
+
+        std::vector<std::unique_ptr<Shard>> my_shards;
+
+        std::atomic<std::size_t> my_active;
+        std::atomic<bool> my_isAccepting;
+        std::atomic<bool> my_isRunning;
+
+        std::mutex my_mutex;
+        std::condition_variable my_isEmpty;
+    };
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline KeyedSerialWorker<KEY, HASH, EQUAL>::KeyedSerialWorker(
+        Worker & worker)
+      : KeyedSerialWorker{worker, 16}
+    {
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline KeyedSerialWorker<KEY, HASH, EQUAL>::KeyedSerialWorker(
+        Worker & worker, std::size_t shards)
+      : my_worker{&worker}
+      , my_active{0}
+      , my_isAccepting{true}
+      , my_isRunning{true}
+    {
+        if(shards == 0)
+        {
+            throw std::invalid_argument{"Invalid shard count"};
+        }
+        my_shards.reserve(shards);
+        for(auto i = 0u; i < shards; ++i)
+        {
+            my_shards.emplace_back(std::make_unique<Shard>());
+        }
+    }
+
+    /// \cond false
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline KeyedSerialWorker<KEY, HASH, EQUAL>::~KeyedSerialWorker() noexcept
+    {
+        KeyedSerialWorker::stop();
+    }
+    /// \endcond
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void KeyedSerialWorker<KEY, HASH, EQUAL>::add(Key const & key,
+                                                        Work work)
+    {
+        auto & shard = shardFor(key);
+        auto strand = houseguest::synchronize(shard.mutex, [this, &shard, &key,
+                                                            &work]() {
+            auto it = shard.strands.find(key);
+            if(it == std::end(shard.strands))
+            {
+                // stop clears my_isAccepting before it reads my_active, so a
+                // strand counted here is either rejected or waited for.
+                ++my_active;
+                if(!my_isAccepting)
+                {
+                    finished();
+                    throw std::runtime_error{"Not accepting work"};
+                }
+                auto inserted = shard.strands.emplace(key, WorkQueue{});
+                inserted.first->second.emplace_back(std::move(work));
+                return &*inserted.first;
+            }
+            if(!my_isAccepting)
+            {
+                throw std::runtime_error{"Not accepting work"};
+            }
+            // already scheduled; the running drain will pick this up
+            it->second.emplace_back(std::move(work));
+            return static_cast<typename StrandMap::value_type *>(nullptr);
+        });
+
+        if(strand != nullptr)
+        {
+            try
+            {
+                my_worker->add(
+                    [this, &shard, strand]() { drain(shard, *strand); });
+            }
+            catch(...)
+            {
+                houseguest::synchronize(shard.mutex, [&shard, &key]() {
+                    shard.strands.erase(key);
+                });
+                finished();
+                throw;
+            }
+        }
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void KeyedSerialWorker<KEY, HASH, EQUAL>::add(Work work)
+    {
+        // counted like a strand so stop waits for it
+        ++my_active;
+        if(!my_isAccepting)
+        {
+            finished();
+            throw std::runtime_error{"Not accepting work"};
+        }
+        try
+        {
+            my_worker->add([w = std::move(work), this]() {
+                w();
+                finished();
+            });
+        }
+        catch(...)
+        {
+            finished();
+            throw;
+        }
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void KeyedSerialWorker<KEY, HASH, EQUAL>::stop()
+    {
+        if(my_isAccepting.exchange(false))
+        {
+            houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+                my_isEmpty.wait(lock, [this]() { return my_active == 0; });
+            });
+            my_isRunning = false;
+        }
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline bool KeyedSerialWorker<KEY, HASH, EQUAL>::isAccepting() const
+        noexcept
+    {
+        return my_isAccepting;
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline bool KeyedSerialWorker<KEY, HASH, EQUAL>::isRunning() const noexcept
+    {
+        return my_isRunning;
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline std::size_t KeyedSerialWorker<KEY, HASH, EQUAL>::activeKeys() const
+        noexcept
+    {
+        return my_active;
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline typename KeyedSerialWorker<KEY, HASH, EQUAL>::Shard &
+    KeyedSerialWorker<KEY, HASH, EQUAL>::shardFor(Key const & key) const
+        noexcept
+    {
+        return *my_shards[HASH{}(key) % my_shards.size()];
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void KeyedSerialWorker<KEY, HASH, EQUAL>::drain(
+        Shard & shard, typename StrandMap::value_type & strand) noexcept
+    {
+        // Only this drain can remove the strand from the map, so it's safe
+        // to hold on to it between batches.  The batch and the strand's
+        // queue trade places so their storage is reused.
+        WorkQueue batch;
+        while(true)
+        {
+            auto const done = houseguest::synchronize(
+                shard.mutex, [&shard, &strand, &batch]() {
+                    batch.swap(strand.second);
+                    if(batch.empty())
+                    {
+                        shard.strands.erase(shard.strands.find(strand.first));
+                        return true;
+                    }
+                    return false;
+                });
+            if(done)
+            {
+                break;
+            }
+            for(auto & work : batch)
+            {
+                work();
+            }
+            batch.clear();
+        }
+        finished();
+    }
+
+    template <typename KEY, typename HASH, typename EQUAL>
+    inline void KeyedSerialWorker<KEY, HASH, EQUAL>::finished() noexcept
+    {
+        // Decrement under my_mutex so stop can't see 0 and return (letting
+        // this KeyedSerialWorker be destroyed) before the notify.  This runs
+        // once per strand, not once per piece of keyed Work.
+        houseguest::synchronize(my_mutex, [this]() {
+            if(--my_active == 0)
+            {
+                my_isEmpty.notify_all();
+            }
+        });
+    }
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef BUREAUCRACY_LIMITEDWORKER_HPP
+#define BUREAUCRACY_LIMITEDWORKER_HPP 1
+
+#include <bureaucracy/worker.hpp>
+#include <bureaucracy/workercommon.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that limits how much of its Work runs at once.
+     *
+     * A LimitedWorker queues its Work and never lets more than a fixed
+     * number of pieces execute concurrently in the underlying Worker.  When
+     * a piece of Work completes the next piece in the queue takes its place.
+     * Work starts in the order it was added.
+     *
+     * This allows several subsystems to share a Threadpool while still
+     * capping the load each one places on something with limited capacity
+     * (e.g., a backend that only accepts a few concurrent requests).  A
+     * SerialWorker behaves like a LimitedWorker with a limit of 1.
+     *
+     * \warning Like a SerialWorker, each slot in a LimitedWorker occupies a
+     *          thread in the underlying Worker for as long as there is Work
+     *          queued.
+     */
+    class LimitedWorker : public Worker
+    {
+    public:
+        /** \brief Construct a LimitedWorker
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] maxConcurrent
+         *      the most pieces of Work that can execute at the same time
+         *
+         * \exception std::invalid_argument
+         *      \p maxConcurrent is 0
+         */
+        LimitedWorker(Worker & worker, std::size_t maxConcurrent);
+
+        void add(Work work) override;
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~LimitedWorker() noexcept override;
+        /// \endcond
+
+    private:
+        void drain() noexcept;
+
+        WorkerCommon<Work> my_worker;
+
+        std::size_t const my_maxConcurrent;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef BUREAUCRACY_LOCKFREESERIALWORKER_HPP
+#define BUREAUCRACY_LOCKFREESERIALWORKER_HPP 1
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A SerialWorker that doesn't lock when Work is added.
+     *
+     * A LockFreeSerialWorker offers the same guarantees as a SerialWorker:
+     * Work is executed in the order it was added and never concurrently.
+     * Work is kept in an intrusive multi-producer, single-consumer queue and
+     * an atomic flag records whether a drain has been scheduled on the
+     * underlying Worker.  The thread that makes the queue non-empty schedules
+     * the drain; every other thread just pushes its Work.
+     *
+     * This makes add cheap and contention-free, which matters when many
+     * LockFreeSerialWorkers (e.g., one per connection) share a Worker.  A
+     * mutex is only taken when the last drain (or the last add deciding
+     * whether to schedule one) finishes, so a thread waiting in stop can be
+     * woken.
+     *
+     * If the underlying Worker rejects a drain, everything queued is
+     * discarded without running and add rethrows the Worker's exception.
+     *
+     * \warning It's very easy for a LockFreeSerialWorker to cause starvation
+     *          if it has a large amount of Work queued or more Work is added.
+     */
+    class LockFreeSerialWorker : public Worker
+    {
+    public:
+        /** \brief Construct a LockFreeSerialWorker
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit LockFreeSerialWorker(Worker & worker);
+
+        void add(Work work) override;
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~LockFreeSerialWorker() noexcept override;
+        LockFreeSerialWorker(LockFreeSerialWorker const &) = delete;
+        LockFreeSerialWorker(LockFreeSerialWorker &&) noexcept = delete;
+        LockFreeSerialWorker &
+        operator=(LockFreeSerialWorker const &) = delete;
+        LockFreeSerialWorker & operator=(LockFreeSerialWorker &&) = delete;
+        /// \endcond
+
+    private:
+        struct Node
+        {
+            std::atomic<Node *> next;
+            Work work;
+        };
+
+        void push(Node * node) noexcept;
+
+        Node * pop() noexcept;
+
+        void drain(bool execute) noexcept;
+
+        void releaseDrain() noexcept;
+
+        Worker * const my_worker;
+
+        // producers push at my_head, the draining thread pops at my_tail
+        std::atomic<Node *> my_head;
+        Node * my_tail;
+        Node my_stub;
+
+        std::atomic<std::size_t> my_queued;
+
+        // Drains that are scheduled or running, plus adds that haven't
+        // decided whether to schedule one yet.  Whoever takes this to 0 does
+        // so under my_mutex, so stop can't return while one still needs this
+        // LockFreeSerialWorker.
+        std::atomic<std::size_t> my_drains;
+        std::atomic<bool> my_isScheduled;
+        std::atomic<bool> my_isAccepting;
+        std::atomic<bool> my_isRunning;
+
+        std::mutex my_mutex;
+        std::condition_variable my_isEmpty;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef BUREAUCRACY_MANUALCLOCK_HPP
+#define BUREAUCRACY_MANUALCLOCK_HPP 1
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+namespace bureaucracy
+{
+    class Timer;
+
+    /** \brief A clock that only moves when it's told to.
+     *
+     * A ManualClock can drive one or more Timers in place of
+     * `std::chrono::steady_clock`.  Time stands still until advance or
+     * advanceTo is called.  The clock then steps through each due time up to
+     * the requested time and attached Timers fire their Events on the
+     * calling thread, so an Event observes the time it was scheduled for.
+     * This makes it possible to simulate long stretches of timer traffic as
+     * fast as the Events can be executed and with deterministic results.
+     *
+     * \warning Advancing a ManualClock from an Event fired by one of its
+     *          Timers is undefined behavior.
+     */
+    class ManualClock
+    {
+        friend class Timer;
+
+    public:
+        /// \brief The type used to measure the distance between two times.
+        using duration = std::chrono::steady_clock::duration;
+
+        /// \brief A point in time on this clock.
+        using time_point = std::chrono::steady_clock::time_point;
+
+        /** \brief Construct a ManualClock.
+         *
+         * \param [in] start
+         *      the initial time reported by the ManualClock
+         */
+        explicit ManualClock(time_point start = time_point{});
+
+        /** \brief Retrieve the current time.
+         *
+         * \return the time this ManualClock has been advanced to
+         */
+        time_point now() const noexcept;
+
+        /** \brief Move time forward.
+         *
+         * Every attached Timer will fire its expired Events before this
+         * function returns.
+         *
+         * \param [in] delta
+         *      the amount of time to move forward; negative values are
+         *      treated as zero
+         */
+        void advance(duration delta);
+
+        /** \brief Move time forward to a specific point.
+         *
+         * Every attached Timer will fire its expired Events before this
+         * function returns.
+         *
+         * \param [in] time
+         *      the new time; if \p time is earlier than now() the clock is
+         *      not moved
+         */
+        void advanceTo(time_point time);
+
+        /// \cond false
+        ~ManualClock() noexcept = default;
+        ManualClock(ManualClock const &) = delete;
+        ManualClock(ManualClock &&) noexcept = delete;
+        ManualClock & operator=(ManualClock const &) = delete;
+        ManualClock & operator=(ManualClock &&) = delete;
+        /// \endcond
+
+    private:
+        void attach(Timer * timer);
+
+        void detach(Timer * timer);
+
+        std::mutex my_mutex;
+
+        std::vector<Timer *> my_timers;
+
+        std::atomic<duration::rep> my_now;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef BUREAUCRACY_ORDEREDWORKER_HPP
+#define BUREAUCRACY_ORDEREDWORKER_HPP 1
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that runs Work in parallel but completes it in order.
+     *
+     * Each piece of Work added to an OrderedWorker can have a Completion.
+     * The Work itself runs on the underlying Worker as soon as it's able
+     * to, in parallel with other Work, but Completions are executed strictly
+     * in the order the Work was added.  A typical use is processing chunks
+     * of a stream in parallel and emitting the results in input order from
+     * the Completions.
+     *
+     * Completions are never executed concurrently with each other.  They're
+     * executed by whichever thread finishes the piece of Work the oldest
+     * outstanding Completion is waiting for, so they should be cheap.
+     *
+     * At most a fixed window of pieces of Work can be outstanding (added but
+     * without their Completion executed).  Completions are kept in a ring
+     * buffer the size of that window, so memory use is bounded no matter
+     * how far ahead fast Work gets of slow Work.
+     *
+     * \warning add blocks while the window is full.  Adding Work from inside
+     *          Work running on the same underlying Worker can deadlock if
+     *          every thread blocks this way.
+     */
+    class OrderedWorker : public Worker
+    {
+    public:
+        /// \brief Work executed in order after a piece of Work completes.
+        using Completion = Work;
+
+        /** \brief Construct an OrderedWorker
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] window
+         *      the most pieces of Work that can be outstanding at once
+         *
+         * \exception std::invalid_argument
+         *      \p window is 0
+         */
+        OrderedWorker(Worker & worker, std::size_t window);
+
+        /** \brief Add Work without a Completion.
+         *
+         * The Work still occupies a place in the window until every piece
+         * of Work added before it has completed.
+         */
+        void add(Work work) override;
+
+        /** \brief Add Work and the Completion to execute, in order, once it
+         *         completes.
+         *
+         * Blocks while the window is full.
+         *
+         * \param [in] work
+         *      a function that will be called at a later time
+         *
+         * \param [in] completion
+         *      a function that will be called after \p work and the
+         *      Completions of all Work added before \p work
+         *
+         * \exception std::runtime_error
+         *      the OrderedWorker is not accepting Work
+         *
+         * \note If the underlying Worker rejects \p work, \p completion is
+         *       discarded and the exception is propagated.
+         */
+        void add(Work work, Completion completion);
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~OrderedWorker() noexcept override;
+        OrderedWorker(OrderedWorker const &) = delete;
+        OrderedWorker(OrderedWorker &&) noexcept = delete;
+        OrderedWorker & operator=(OrderedWorker const &) = delete;
+        OrderedWorker & operator=(OrderedWorker &&) = delete;
+        /// \endcond
+
+    private:
+        struct Slot
+        {
+            Completion completion;
+            bool isDone;
+        };
+
+        void finished(std::uint64_t sequence) noexcept;
+
+        Slot & slotFor(std::uint64_t sequence) noexcept;
+
+        Worker * const my_worker;
+
+        // A ring buffer indexed by sequence number
+        std::vector<Slot> my_slots;
+
+        std::uint64_t my_nextSequence;
+        std::uint64_t my_nextCompletion;
+
+        std::condition_variable my_hasSpace;
+        std::condition_variable my_isIdle;
+        mutable std::mutex my_mutex;
+
+        // set while a thread is executing Completions
+        bool my_isCompleting;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    inline void OrderedWorker::add(Work work)
+    {
+        add(std::move(work), Completion{});
+    }
+} // namespace bureaucracy
+
+#endif
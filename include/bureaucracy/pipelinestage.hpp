@@ -0,0 +1,391 @@
+#ifndef BUREAUCRACY_PIPELINESTAGE_HPP
+#define BUREAUCRACY_PIPELINESTAGE_HPP 1
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+#include <bureaucracy/worker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+namespace bureaucracy
+{
+    /** \brief One stage of a pipeline connected by bounded queues.
+     *
+     * A PipelineStage accepts values of type IN, keeps them in a bounded
+     * queue, and processes them on a Worker with up to a fixed number of
+     * values in flight at once (1 for a serial stage).  A stage either ends
+     * the pipeline with a Handler or transforms each value and pushes the
+     * result to the next stage:
+     *
+     * \code
+     * PipelineStage<std::string> serialize{pool, write, 1, 64};
+     * PipelineStage<Record> enrich{pool, addDetails, serialize, 4, 64};
+     * PipelineStage<std::string> parse{pool, parseRecord, enrich, 4, 64};
+     * parse.push(line);
+     * \endcode
+     *
+     * When a stage's queue is full push blocks, so a slow stage applies
+     * backpressure all the way to the producer instead of letting queues
+     * grow without bound.  Each stage counts the values it has processed,
+     * its current queue depth, and how often a push had to wait, which is
+     * usually enough to find the bottleneck.
+     *
+     * Stop stages in the order values flow through them (declaring them in
+     * reverse order, as above, makes the destructors do this) so each stage
+     * can flush into the next.  A value is dropped, rather than processed,
+     * if the Handler or transform throws, if the next stage has already
+     * stopped, or if the Worker refuses to drain the queue holding it.
+     *
+     * \tparam IN
+     *      the type of value this stage accepts
+     *
+     * \warning Each value in flight occupies a thread in the Worker, and a
+     *          stage whose next stage is full blocks that thread.  The
+     *          Worker needs more threads than the total parallelism of the
+     *          stages sharing it, or a full pipeline can deadlock.
+     */
+    template <typename IN>
+    class PipelineStage
+    {
+    public:
+        /// \brief The type of value this stage accepts.
+        using Input = IN;
+
+        /// \brief A function that consumes a value at the end of a pipeline.
+        using Handler = std::function<void(IN)>;
+
+        /** \brief Construct a PipelineStage that ends a pipeline.
+         *
+         * \param [in] worker
+         *      the Worker that runs \p handler
+         *
+         * \param [in] handler
+         *      the function to call with each value
+         *
+         * \param [in] parallelism
+         *      the most values \p handler is called with at the same time
+         *
+         * \param [in] capacity
+         *      the most values that can be queued before push blocks
+         *
+         * \exception std::invalid_argument
+         *      \p parallelism or \p capacity is 0
+         */
+        PipelineStage(Worker & worker, Handler handler,
+                      std::size_t parallelism, std::size_t capacity);
+
+        /** \brief Construct a PipelineStage that feeds another stage.
+         *
+         * \param [in] worker
+         *      the Worker that runs \p transform
+         *
+         * \param [in] transform
+         *      a function that converts an IN to the next stage's input; it
+         *      may be called from several threads at once
+         *
+         * \param [in] next
+         *      the stage that receives the output of \p transform
+         *
+         * \param [in] parallelism
+         *      the most values \p transform is called with at the same time
+         *
+         * \param [in] capacity
+         *      the most values that can be queued before push blocks
+         *
+         * \exception std::invalid_argument
+         *      \p parallelism or \p capacity is 0
+         *
+         * \warning \p next must outlive this PipelineStage.
+         */
+        template <typename TRANSFORM, typename OUT>
+        PipelineStage(Worker & worker, TRANSFORM transform,
+                      PipelineStage<OUT> & next, std::size_t parallelism,
+                      std::size_t capacity);
+
+        /** \brief Queue a value, waiting for space if the queue is full.
+         *
+         * \param [in] value
+         *      the value to process
+         *
+         * \exception std::runtime_error
+         *      the PipelineStage is not accepting values
+         */
+        void push(IN value);
+
+        /** \brief Stop accepting values and wait for queued values to be
+         *         processed.
+         */
+        void stop();
+
+        /** \brief Determine if this PipelineStage is accepting new values.
+         *
+         * \retval true this PipelineStage is accepting new values
+         * \retval false this PipelineStage is not accepting new values
+         */
+        bool isAccepting() const noexcept;
+
+        /** \brief Determine if this PipelineStage is running.
+         *
+         * \retval true this PipelineStage is running
+         * \retval false this PipelineStage is not running
+         */
+        bool isRunning() const noexcept;
+
+        /** \brief Retrieve the number of values this stage has processed.
+         *
+         * \return the number of values processed
+         */
+        std::uint64_t processed() const noexcept;
+
+        /** \brief Retrieve the number of values waiting to be processed.
+         *
+         * \return the current queue depth
+         */
+        std::size_t queued() const noexcept;
+
+        /** \brief Retrieve the number of times push waited for space.
+         *
+         * \return the number of pushes that were blocked by backpressure
+         */
+        std::uint64_t stalls() const noexcept;
+
+        /** \brief Retrieve the number of values that couldn't be processed.
+         *
+         * \return the number of values whose Handler or transform threw,
+         *      whose result the next stage refused, or whose queue the
+         *      Worker wouldn't drain
+         */
+        std::uint64_t dropped() const noexcept;
+
+        /// \cond false
+        ~PipelineStage() noexcept;
+        PipelineStage(PipelineStage const &) = delete;
+        PipelineStage(PipelineStage &&) noexcept = delete;
+        PipelineStage & operator=(PipelineStage const &) = delete;
+        PipelineStage & operator=(PipelineStage &&) = delete;
+        /// \endcond
+
+    private:
+        void drain() noexcept;
+
+        Worker * const my_worker;
+
+        Handler const my_handler;
+
+        std::size_t const my_parallelism;
+        std::size_t const my_capacity;
+
+        std::deque<IN> my_queue;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_hasSpace;
+        std::condition_variable my_isIdle;
+
+        std::size_t my_drains;
+        std::uint64_t my_processed;
+        std::uint64_t my_stalls;
+        std::uint64_t my_dropped;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    template <typename IN>
+    inline PipelineStage<IN>::PipelineStage(Worker & worker, Handler handler,
+                                            std::size_t parallelism,
+                                            std::size_t capacity)
+      : my_worker{&worker}
+      , my_handler{std::move(handler)}
+      , my_parallelism{parallelism}
+      , my_capacity{capacity}
+      , my_drains{0}
+      , my_processed{0}
+      , my_stalls{0}
+      , my_dropped{0}
+      , my_isAccepting{true}
+      , my_isRunning{true}
+    {
+        if(parallelism == 0)
+        {
+            throw std::invalid_argument{"Invalid parallelism"};
+        }
+        if(capacity == 0)
+        {
+            throw std::invalid_argument{"Invalid capacity"};
+        }
+    }
+
+    template <typename IN>
+    template <typename TRANSFORM, typename OUT>
+    inline PipelineStage<IN>::PipelineStage(Worker & worker,
+                                            TRANSFORM transform,
+                                            PipelineStage<OUT> & next,
+                                            std::size_t parallelism,
+                                            std::size_t capacity)
+      : PipelineStage{worker,
+                      [t = std::move(transform), &next](IN value) {
+                          next.push(t(std::move(value)));
+                      },
+                      parallelism, capacity}
+    {
+    }
+
+    /// \cond false
+    template <typename IN>
+    inline PipelineStage<IN>::~PipelineStage() noexcept
+    {
+        stop();
+    }
+    /// \endcond
+
+    template <typename IN>
+    inline void PipelineStage<IN>::push(IN value)
+    {
+        auto const startDrain = houseguest::synchronize_unique(
+            my_mutex, [this, &value](auto lock) {
+                if(my_isAccepting && !(my_queue.size() < my_capacity))
+                {
+                    ++my_stalls;
+                    my_hasSpace.wait(lock, [this]() {
+                        return !my_isAccepting ||
+                               (my_queue.size() < my_capacity);
+                    });
+                }
+                if(!my_isAccepting)
+                {
+                    throw std::runtime_error{"Not accepting work"};
+                }
+                my_queue.emplace_back(std::move(value));
+                if(my_drains < my_parallelism)
+                {
+                    ++my_drains;
+                    return true;
+                }
+                return false;
+            });
+
+        if(startDrain)
+        {
+            try
+            {
+                my_worker->add([this]() { drain(); });
+            }
+            catch(...)
+            {
+                houseguest::synchronize(my_mutex, [this]() {
+                    // without a drain nothing would ever empty the queue
+                    if(--my_drains == 0)
+                    {
+                        my_dropped += my_queue.size();
+                        my_queue.clear();
+                        my_hasSpace.notify_all();
+                        my_isIdle.notify_all();
+                    }
+                });
+                throw;
+            }
+        }
+    }
+
+    template <typename IN>
+    inline void PipelineStage<IN>::stop()
+    {
+        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            if(my_isAccepting)
+            {
+                my_isAccepting = false;
+                my_hasSpace.notify_all();
+                my_isIdle.wait(lock, [this]() {
+                    return my_queue.empty() && (my_drains == 0);
+                });
+                my_isRunning = false;
+            }
+        });
+    }
+
+    template <typename IN>
+    inline bool PipelineStage<IN>::isAccepting() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isAccepting; });
+    }
+
+    template <typename IN>
+    inline bool PipelineStage<IN>::isRunning() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_isRunning; });
+    }
+
+    template <typename IN>
+    inline std::uint64_t PipelineStage<IN>::processed() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_processed; });
+    }
+
+    template <typename IN>
+    inline std::size_t PipelineStage<IN>::queued() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_queue.size(); });
+    }
+
+    template <typename IN>
+    inline std::uint64_t PipelineStage<IN>::stalls() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_stalls; });
+    }
+
+    template <typename IN>
+    inline std::uint64_t PipelineStage<IN>::dropped() const noexcept
+    {
+        return houseguest::synchronize(my_mutex,
+                                       [this]() { return my_dropped; });
+    }
+
+    template <typename IN>
+    inline void PipelineStage<IN>::drain() noexcept
+    {
+        // Each drain is one unit of parallelism; it keeps taking values
+        // until the queue is empty.
+        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            while(!my_queue.empty())
+            {
+                auto value = std::move(my_queue.front());
+                my_queue.pop_front();
+                my_hasSpace.notify_one();
+                lock.unlock();
+                auto handled = true;
+                try
+                {
+                    my_handler(std::move(value));
+                }
+                catch(...)
+                {
+                    // there's nobody to report to, so count it instead
+                    handled = false;
+                }
+                lock.lock();
+                if(handled)
+                {
+                    ++my_processed;
+                }
+                else
+                {
+                    ++my_dropped;
+                }
+            }
+            --my_drains;
+            my_isIdle.notify_all();
+        });
+    }
+} // namespace bureaucracy
+
+#endif
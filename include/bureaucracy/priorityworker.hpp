@@ -1,8 +1,13 @@
 #ifndef BUREAUCRACY_PRIORITYWORKER_HPP
 #define BUREAUCRACY_PRIORITYWORKER_HPP 1
 
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
 #include <bureaucracy/worker.hpp>
-#include <bureaucracy/workercommon.hpp>
 
 namespace bureaucracy
 {
@@ -15,6 +20,19 @@ namespace bureaucracy
      * the Worker it leverages may offer additional guarantees about the order
      * of completion.
      *
+     * Work with the same Priority executes in the order it was added.
+     * Queued Work is kept in a binary heap by default; if every Priority is
+     * known to fall in a small range a PriorityWorker can instead keep one
+     * FIFO bucket per Priority, making add and removal constant time.
+     *
+     * By default low-Priority Work can wait indefinitely if higher-Priority
+     * Work keeps arriving.  A PriorityWorker constructed with an
+     * AgingInterval instead treats queued Work as one Priority more
+     * important for every AgingInterval it has waited, so Work with Priority
+     * `p` waits at most about `p` AgingIntervals behind Work added after it.
+     * Because every piece of Work ages at the same rate its effective
+     * Priority is fixed when it's added; nothing is rescanned as time passes.
+     *
      * \note PriorityWorker requires extra overhead (one function call) for
      *       each piece of Work executed.
      */
@@ -25,6 +43,81 @@ namespace bureaucracy
          */
         using Priority = unsigned int;
 
+        /** \brief How long Work waits to gain one level of Priority.
+         */
+        using AgingInterval = std::chrono::steady_clock::duration;
+
+        /** \brief A reference to Work queued in a PriorityWorker.
+         *
+         * A Handle can cancel its Work or change its Priority as long as the
+         * Work is still queued.  Both operations take logarithmic time (or
+         * constant time for a PriorityWorker with a fixed range of
+         * Priorities).
+         *
+         * \warning A Handle must not be used after the PriorityWorker that
+         *          created it is destroyed.
+         */
+        class Handle
+        {
+            friend class PriorityWorker;
+
+        public:
+            /// \brief An Identifier for queued Work.
+            using Id = std::uint64_t;
+
+            /// \brief Result of a call to cancel.
+            enum class CancelStatus
+            {
+                cancelled, ///< the Work was cancelled
+                failed     ///< the Work is running or has already run
+            };
+
+            /** \brief Construct a Handle.
+             *
+             * \internal
+             *
+             * \param [in] worker
+             *      the PriorityWorker associated with this Handle
+             *
+             * \param [in] id
+             *      the Id of the Work
+             */
+            Handle(PriorityWorker * worker, Id id);
+
+            /** \brief Cancel the Work if it's still queued.
+             *
+             * Cancelled Work is never executed.
+             *
+             * \retval CancelStatus::cancelled
+             *      The Work was cancelled successfully.
+             *
+             * \retval CancelStatus::failed
+             *      The Work has already started or was already cancelled.
+             */
+            CancelStatus cancel();
+
+            /** \brief Change the Priority of the Work if it's still queued.
+             *
+             * The Work is scheduled as if it had just been added with \p
+             * priority, so it runs after Work already queued with the same
+             * Priority.
+             *
+             * \param [in] priority
+             *      the new Priority of the Work
+             *
+             * \retval true the Work's Priority was changed
+             * \retval false the Work has already started or was cancelled
+             *
+             * \exception std::invalid_argument
+             *      \p priority is outside the range given at construction
+             */
+            bool setPriority(Priority priority);
+
+        private:
+            PriorityWorker * my_worker;
+            Id my_id;
+        };
+
         /** \brief Construct a PriorityWorker.
          *
          * Work will be fed to \p worker for execution.  If the
@@ -40,6 +133,73 @@ namespace bureaucracy
          */
         PriorityWorker(Worker & worker, Priority defaultPriority = 0);
 
+        /** \brief Construct a PriorityWorker with a fixed range of
+         *         Priorities.
+         *
+         * Work is kept in one bucket per Priority, so adding and removing
+         * Work takes constant time regardless of how much is queued.  This is
+         * a good fit when there are only a handful of Priorities.
+         *
+         * \param [in] worker
+         *      a Worker that will process Work items
+         *
+         * \param [in] defaultPriority
+         *      the Priority to use if one is not specified in add
+         *
+         * \param [in] levels
+         *      the number of Priorities; valid Priorities are in the range
+         *      [0, \p levels)
+         *
+         * \exception std::invalid_argument
+         *      \p levels is 0 or \p defaultPriority is not less than \p
+         *      levels
+         */
+        PriorityWorker(Worker & worker, Priority defaultPriority,
+                       Priority levels);
+
+        /** \brief Construct a PriorityWorker that ages queued Work.
+         *
+         * \param [in] worker
+         *      a Worker that will process Work items
+         *
+         * \param [in] defaultPriority
+         *      the Priority to use if one is not specified in add
+         *
+         * \param [in] agingInterval
+         *      how long queued Work waits to gain one level of Priority
+         *
+         * \exception std::invalid_argument
+         *      \p agingInterval is not positive
+         */
+        PriorityWorker(Worker & worker, Priority defaultPriority,
+                       AgingInterval agingInterval);
+
+        /** \brief Construct a PriorityWorker with a fixed range of
+         *         Priorities that ages queued Work.
+         *
+         * Choosing the next piece of Work compares the oldest Work in each
+         * bucket, so it takes time proportional to \p levels.
+         *
+         * \param [in] worker
+         *      a Worker that will process Work items
+         *
+         * \param [in] defaultPriority
+         *      the Priority to use if one is not specified in add
+         *
+         * \param [in] levels
+         *      the number of Priorities; valid Priorities are in the range
+         *      [0, \p levels)
+         *
+         * \param [in] agingInterval
+         *      how long queued Work waits to gain one level of Priority
+         *
+         * \exception std::invalid_argument
+         *      \p levels is 0, \p defaultPriority is not less than \p
+         *      levels, or \p agingInterval is not positive
+         */
+        PriorityWorker(Worker & worker, Priority defaultPriority,
+                       Priority levels, AgingInterval agingInterval);
+
         void add(Work work) override;
 
         /** \brief Add Work with a Priority
@@ -54,8 +214,13 @@ namespace bureaucracy
          *
          * \param [in] priority
          *      the Priority of \p work
+         *
+         * \return a Handle that can cancel or re-prioritize \p work
+         *
+         * \exception std::invalid_argument
+         *      \p priority is outside the range given at construction
          */
-        void add(Work work, Priority priority);
+        Handle add(Work work, Priority priority);
 
         void stop() override;
 
@@ -68,28 +233,41 @@ namespace bureaucracy
         /// \endcond
 
     private:
-        struct PriorityWork
-        {
-            Priority priority;
-            Work work;
+        class Queue;
+        class HeapQueue;
+        class BucketQueue;
 
-            void operator()();
-        };
+        Handle::CancelStatus cancel(Handle::Id id);
+
+        bool setPriority(Handle::Id id, Priority priority);
+
+        void runNext() noexcept;
 
-        WorkerCommon<PriorityWork> my_worker;
+        Worker * const my_worker;
+
+        std::unique_ptr<Queue> const my_queue;
 
         Priority const my_defaultPriority;
+
+        std::condition_variable my_isEmpty;
+        mutable std::mutex my_mutex;
+
+        // Calls to runNext that haven't picked their Work yet.  There's never
+        // more than one per live piece of Work when Work is added, so Work
+        // that's cancelled leaves its runNext for the next add to reuse.
+        std::size_t my_scheduled;
+
+        // calls to runNext that are queued or running
+        std::size_t my_outstanding;
+
+        bool my_isAccepting;
+        bool my_isRunning;
     };
 
     inline void PriorityWorker::add(Work work)
     {
         add(std::move(work), my_defaultPriority);
     }
-
-    inline void PriorityWorker::PriorityWork::operator()()
-    {
-        work();
-    }
 } // namespace bureaucracy
 
 #endif
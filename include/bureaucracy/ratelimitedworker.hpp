@@ -0,0 +1,142 @@
+#ifndef BUREAUCRACY_RATELIMITEDWORKER_HPP
+#define BUREAUCRACY_RATELIMITEDWORKER_HPP 1
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include <bureaucracy/timer.hpp>
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that limits the rate Work is started.
+     *
+     * A RateLimitedWorker feeds Work to another Worker according to a token
+     * bucket.  The bucket holds up to a burst's worth of tokens and refills
+     * at a fixed rate; each piece of Work spends a token when it's handed to
+     * the underlying Worker.  Work that arrives when the bucket is empty is
+     * queued, and a Timer Event releases it as tokens become available, so
+     * no thread is ever blocked waiting for the rate.
+     *
+     * Work is handed to the underlying Worker in the order it was added.
+     */
+    class RateLimitedWorker : public Worker
+    {
+    public:
+        /// \brief A measure of time spent waiting for the rate.
+        using Duration = Timer::Time::duration;
+
+        /** \brief Construct a RateLimitedWorker.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] timer
+         *      the Timer used to release queued Work
+         *
+         * \param [in] rate
+         *      the number of pieces of Work to release per second
+         *
+         * \param [in] burst
+         *      the most pieces of Work that can be released at once after a
+         *      quiet period
+         *
+         * \exception std::invalid_argument
+         *      \p rate is not positive or \p burst is 0
+         *
+         * \warning \p timer must outlive this RateLimitedWorker.
+         */
+        RateLimitedWorker(Worker & worker, Timer & timer, double rate,
+                          std::size_t burst);
+
+        /** \brief Add Work, subject to the rate.
+         *
+         * \param [in] work
+         *      a piece of Work
+         *
+         * \exception std::runtime_error
+         *      the RateLimitedWorker is not accepting Work
+         */
+        void add(Work work) override;
+
+        /** \brief Stop accepting Work and wait for queued Work to complete.
+         *
+         * The pending alarm is cancelled and any queued Work is handed to
+         * the underlying Worker immediately, without waiting for the rate.
+         */
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /** \brief Retrieve the total time Work has spent queued.
+         *
+         * \return the sum of the time each piece of Work waited for a token
+         */
+        Duration throttledTime() const noexcept;
+
+        /** \brief Retrieve the number of pieces of Work that were dropped.
+         *
+         * Queued Work is dropped if the underlying Worker rejects it, or if
+         * the Timer stops before the Work can be released.
+         *
+         * \return the number of pieces of Work that were never executed
+         */
+        std::size_t dropped() const noexcept;
+
+        /// \cond false
+        ~RateLimitedWorker() noexcept override;
+        RateLimitedWorker(RateLimitedWorker const &) = delete;
+        RateLimitedWorker(RateLimitedWorker &&) noexcept = delete;
+        RateLimitedWorker & operator=(RateLimitedWorker const &) = delete;
+        RateLimitedWorker & operator=(RateLimitedWorker &&) = delete;
+        /// \endcond
+
+    private:
+        struct Queued
+        {
+            Work work;
+            Timer::Time added;
+        };
+
+        void refill(Timer::Time now) noexcept;
+
+        void arm(Timer::Time now);
+
+        void fire();
+
+        void dispatch(Work work);
+
+        void release(std::vector<Work> batch);
+
+        void finished() noexcept;
+
+        Worker * const my_worker;
+        Timer * const my_timer;
+
+        double const my_rate;
+        double const my_burst;
+
+        mutable std::mutex my_mutex;
+        std::condition_variable my_idle;
+
+        std::deque<Queued> my_queue;
+
+        double my_tokens;
+        Timer::Time my_lastRefill;
+        Duration my_throttled;
+        std::size_t my_dropped;
+
+        Timer::Item my_alarmItem;
+        bool my_isArmed;
+        std::size_t my_outstanding;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef BUREAUCRACY_READERWRITERWORKER_HPP
+#define BUREAUCRACY_READERWRITERWORKER_HPP 1
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that runs shared Work in parallel and exclusive Work
+     *         alone.
+     *
+     * A ReaderWriterWorker protects a resource the same way a
+     * reader/writer lock would, without tying up threads waiting for the
+     * lock.  Work is started in the order it was added:
+     *   - consecutive pieces of shared Work run in parallel on the
+     *     underlying Worker
+     *   - a piece of exclusive Work waits for everything added before it to
+     *     complete, and nothing added after it starts until it completes
+     *
+     * Work added with the single-argument add is treated as exclusive, so
+     * a ReaderWriterWorker used only through the Worker interface behaves
+     * like a SerialWorker.
+     *
+     * \note Exclusive Work is never starved by a steady stream of shared
+     *       Work, since shared Work added after it waits its turn.
+     */
+    class ReaderWriterWorker : public Worker
+    {
+    public:
+        /** \brief Construct a ReaderWriterWorker
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit ReaderWriterWorker(Worker & worker);
+
+        /** \brief Add exclusive Work.
+         *
+         * This is the same as addExclusive.
+         */
+        void add(Work work) override;
+
+        /** \brief Add Work that can run alongside other shared Work.
+         *
+         * \param [in] work
+         *      a function that will be called at a later time
+         *
+         * \exception std::runtime_error
+         *      the ReaderWriterWorker is not accepting Work
+         */
+        void addShared(Work work);
+
+        /** \brief Add Work that must run alone.
+         *
+         * \param [in] work
+         *      a function that will be called at a later time
+         *
+         * \exception std::runtime_error
+         *      the ReaderWriterWorker is not accepting Work
+         */
+        void addExclusive(Work work);
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~ReaderWriterWorker() noexcept override;
+        ReaderWriterWorker(ReaderWriterWorker const &) = delete;
+        ReaderWriterWorker(ReaderWriterWorker &&) noexcept = delete;
+        ReaderWriterWorker & operator=(ReaderWriterWorker const &) = delete;
+        ReaderWriterWorker & operator=(ReaderWriterWorker &&) = delete;
+        /// \endcond
+
+    private:
+        struct Item
+        {
+            Work work;
+            bool exclusive;
+        };
+
+        void enqueue(Work work, bool exclusive);
+
+        void dispatch();
+
+        void finished(bool exclusive) noexcept;
+
+        bool isIdle() const noexcept;
+
+        Worker * const my_worker;
+
+        // Work that can't start yet; the front is always the next to start.
+        std::deque<Item> my_queue;
+
+        std::condition_variable my_isIdle;
+        mutable std::mutex my_mutex;
+
+        std::size_t my_sharedRunning;
+        bool my_exclusiveRunning;
+
+        bool my_isAccepting;
+        bool my_isRunning;
+    };
+
+    inline void ReaderWriterWorker::add(Work work)
+    {
+        addExclusive(std::move(work));
+    }
+} // namespace bureaucracy
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef BUREAUCRACY_SERIALWORKER_HPP
 #define BUREAUCRACY_SERIALWORKER_HPP 1
 
+#include <chrono>
+
 #include <bureaucracy/worker.hpp>
 #include <bureaucracy/workercommon.hpp>
 
@@ -14,11 +16,28 @@ namespace bureaucracy
      * SerialWorker completes.
      *
      * \warning It's very easy for a SerialWorker to cause starvation if it
-     *          has a large amount of Work queued or more Work is added.
+     *          has a large amount of Work queued or more Work is added.  A
+     *          Budget limits how long a SerialWorker holds on to a thread.
      */
     class SerialWorker : public Worker
     {
     public:
+        /** \brief Limits on how much Work is executed before a SerialWorker
+         *         gives its thread back.
+         *
+         * Once either limit is reached the SerialWorker re-adds itself to
+         * the back of the underlying Worker's queue so other Work sharing
+         * that Worker gets a turn.  A value of zero means no limit.
+         */
+        struct Budget
+        {
+            /// \brief the maximum number of pieces of Work to execute
+            std::size_t maxItems;
+
+            /// \brief the maximum amount of time to spend executing Work
+            std::chrono::steady_clock::duration timeSlice;
+        };
+
         /** \brief Construct a SerialWorker
          *
          * \param [in] worker
@@ -26,6 +45,19 @@ namespace bureaucracy
          */
         explicit SerialWorker(Worker & worker);
 
+        /** \brief Construct a SerialWorker that shares its thread.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         *
+         * \param [in] budget
+         *      how much Work to execute each time the SerialWorker runs
+         *
+         * \note A piece of Work is never interrupted, so a time slice can be
+         *       overrun by however long the last piece of Work takes.
+         */
+        SerialWorker(Worker & worker, Budget budget);
+
         void add(Work work) override;
 
         void stop() override;
@@ -39,7 +71,11 @@ namespace bureaucracy
         /// \endcond
 
     private:
+        void drain() noexcept;
+
         WorkerCommon<Work> my_worker;
+
+        Budget const my_budget;
     };
 } // namespace bureaucracy
 
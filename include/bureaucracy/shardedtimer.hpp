@@ -0,0 +1,204 @@
+#ifndef BUREAUCRACY_SHARDEDTIMER_HPP
+#define BUREAUCRACY_SHARDEDTIMER_HPP 1
+
+#include <memory>
+#include <vector>
+
+#include <bureaucracy/timer.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A set of independent Timers that share the load of Events.
+     *
+     * A ShardedTimer owns several Timers (shards), each with its own thread
+     * and lock.  Events are added to a shard chosen by the calling thread so
+     * unrelated threads rarely contend with each other and firing is spread
+     * across multiple timer threads.
+     *
+     * Events added from the same thread are handled by the same shard, so
+     * the ordering guarantees of Timer still apply to them.  No ordering is
+     * guaranteed between Events added from different threads.
+     */
+    class ShardedTimer
+    {
+    public:
+        /// \brief An Item added to a ShardedTimer.
+        class Item
+        {
+            friend class ShardedTimer;
+
+        public:
+            /** \brief Construct an Item.
+             *
+             * \internal
+             *
+             * \param [in] shard
+             *      the index of the shard that owns \p item
+             *
+             * \param [in] item
+             *      the Item returned by the shard
+             */
+            Item(std::size_t shard, Timer::Item item);
+
+        private:
+            std::size_t my_shard;
+            Timer::Item my_item;
+        };
+
+        /// \brief A function a ShardedTimer can invoke.
+        using Event = Timer::Event;
+
+        /// \brief A point in time when an Event can be invoked.
+        using Time = Timer::Time;
+
+        /** \brief Construct a ShardedTimer.
+         *
+         * \param [in] shards
+         *      the number of Timers to spread Events across
+         *
+         * \exception std::invalid_argument
+         *      \p shards is 0
+         *
+         * \exception std::exception
+         *      an exception was emitted by the standard library
+         */
+        explicit ShardedTimer(std::size_t shards);
+
+        /** \brief Construct a ShardedTimer driven by a ManualClock.
+         *
+         * \param [in] shards
+         *      the number of Timers to spread Events across
+         *
+         * \param [in] clock
+         *      the clock every shard follows
+         *
+         * \exception std::invalid_argument
+         *      \p shards is 0
+         *
+         * \exception std::exception
+         *      an exception was emitted by the standard library
+         *
+         * \see Timer::Timer(ManualClock &)
+         */
+        ShardedTimer(std::size_t shards, ManualClock & clock);
+
+        /** \brief Add an Event that fires at a specific time.
+         *
+         * \param [in] event
+         *      an Event to fire when it's \p due
+         *
+         * \param [in] due
+         *      an exact (not relative) time to invoke \p event
+         *
+         * \see Timer::add
+         */
+        Item add(Event event, Time due);
+
+        /** \brief Add an Event that fires at a specific time.
+         *
+         * \param [in] event
+         *      an Event to fire when it's \p due
+         *
+         * \param [in] due
+         *      An exact (not relative) time to invoke \p event.  This will be
+         *      converted to a Time.
+         *
+         * \see Timer::add
+         */
+        template <typename CLOCK>
+        Item add(Event event, std::chrono::time_point<CLOCK> due);
+
+        /** \brief Add an Event that fires after a delay.
+         *
+         * \param [in] event
+         *      an Event to fire after \p delay time
+         *
+         * \param [in] delay
+         *      a duration to wait
+         *
+         * \see Timer::add
+         */
+        template <typename... ARGS>
+        Item add(Event event, std::chrono::duration<ARGS...> delay);
+
+        /** \brief Stop every shard.
+         *
+         * \note Any scheduled Events will _not_ be called.
+         *
+         * \see Timer::stop
+         */
+        void stop();
+
+        /** \brief Determine if this ShardedTimer is accepting new Events.
+         *
+         * \retval true every shard is accepting new Events
+         * \retval false at least one shard is not accepting new Events
+         */
+        bool isAccepting() const noexcept;
+
+        /** \brief Determine if this ShardedTimer has running shards.
+         *
+         * \retval true at least one shard's thread is running
+         * \retval false no shard's thread is running
+         */
+        bool isRunning() const noexcept;
+
+        /** \brief Retrieve the current time according to this ShardedTimer's
+         *         clock.
+         *
+         * \return the current time
+         */
+        Time now() const noexcept;
+
+        /** \brief Cancel an Item if possible.
+         *
+         * The request is forwarded to the shard that owns \p item.
+         *
+         * \see Timer::cancel
+         */
+        Timer::Item::CancelStatus cancel(Item item);
+
+        /** \brief Retrieve the number of shards.
+         *
+         * \return the number of Timers used by this ShardedTimer
+         */
+        std::size_t shards() const noexcept;
+
+        /// \cond false
+        ~ShardedTimer() noexcept;
+        ShardedTimer(ShardedTimer const &) = delete;
+        ShardedTimer(ShardedTimer &&) noexcept = delete;
+        ShardedTimer & operator=(ShardedTimer const &) = delete;
+        ShardedTimer & operator=(ShardedTimer &&) = delete;
+        /// \endcond
+
+    private:
+        std::size_t currentShard() const noexcept;
+
+        std::vector<std::unique_ptr<Timer>> my_shards;
+    };
+
+    inline ShardedTimer::Item ShardedTimer::add(Event event, Time due)
+    {
+        auto const shard = currentShard();
+        return Item{shard, my_shards[shard]->add(std::move(event), due)};
+    }
+
+    template <typename CLOCK>
+    inline ShardedTimer::Item
+    ShardedTimer::add(Event event, std::chrono::time_point<CLOCK> due)
+    {
+        auto const shard = currentShard();
+        return Item{shard, my_shards[shard]->add(std::move(event), due)};
+    }
+
+    template <typename... ARGS>
+    inline ShardedTimer::Item
+    ShardedTimer::add(Event event, std::chrono::duration<ARGS...> delay)
+    {
+        auto const shard = currentShard();
+        return Item{shard, my_shards[shard]->add(std::move(event), delay)};
+    }
+} // namespace bureaucracy
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef BUREAUCRACY_TASKGROUP_HPP
+#define BUREAUCRACY_TASKGROUP_HPP 1
+
+#include <memory>
+
+#include <bureaucracy/worker.hpp>
+
+namespace bureaucracy
+{
+    /** \brief A Worker that can wait for a group of Work to complete.
+     *
+     * A TaskGroup feeds Work to another Worker and lets a caller wait until
+     * every piece of Work added to the group has completed.  While waiting
+     * the calling thread executes the group's queued Work itself rather than
+     * blocking, so waiting on a TaskGroup from one of a Threadpool's threads
+     * (e.g., nested fork-join) can't deadlock the Threadpool: if every
+     * thread is busy waiting, the waiters do the Work.
+     *
+     * Each piece of Work is executed exactly once, either by the underlying
+     * Worker or by a thread in wait, whichever gets to it first.
+     *
+     * \note TaskGroup adds a small overhead (one function call) to each
+     *       piece of Work executed by the underlying Worker.
+     */
+    class TaskGroup : public Worker
+    {
+    public:
+        /** \brief Construct a TaskGroup.
+         *
+         * \param [in] worker
+         *      the Worker to feed Work to
+         */
+        explicit TaskGroup(Worker & worker);
+
+        void add(Work work) override;
+
+        /** \brief Wait for all Work in the group to complete.
+         *
+         * Queued Work is executed on the calling thread until none is left,
+         * then wait blocks until Work that's already running completes.
+         * Work added while waiting (e.g., by Work in the group) is waited
+         * for too.  The TaskGroup keeps accepting Work and can be waited on
+         * again.
+         *
+         * \warning Calling wait from Work in the same TaskGroup will
+         *          deadlock.
+         */
+        void wait();
+
+        void stop() override;
+
+        bool isAccepting() const noexcept override;
+
+        bool isRunning() const noexcept override;
+
+        /// \cond false
+        ~TaskGroup() noexcept override;
+        TaskGroup(TaskGroup const &) = delete;
+        TaskGroup(TaskGroup &&) noexcept = delete;
+        TaskGroup & operator=(TaskGroup const &) = delete;
+        TaskGroup & operator=(TaskGroup &&) = delete;
+        /// \endcond
+
+    private:
+        struct State;
+
+        Worker * const my_worker;
+
+        // Shared with the functions queued in my_worker, which can outlive
+        // the TaskGroup if wait ran their Work first.
+        std::shared_ptr<State> const my_state;
+    };
+} // namespace bureaucracy
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef BUREAUCRACY_THREADPOOL_HPP
 #define BUREAUCRACY_THREADPOOL_HPP 1
 
+#include <bureaucracy/cancellationtoken.hpp>
 #include <bureaucracy/threadpoolbase.hpp>
 #include <bureaucracy/worker.hpp>
 
@@ -11,10 +12,20 @@ namespace bureaucracy
      * Threadpool distributes Work among a set of threads.  Work is guaranteed
      * to be invoked in same order it was added to the Threadpool but does not
      * guarantee Work will complete in any particular order.
+     *
+     * A Threadpool can also be built with several priority lanes.  Threads
+     * always take Work from the most important non-empty lane, and Work in
+     * the same lane is invoked in the order it was added.  This offers the
+     * same scheduling as a PriorityWorker without queueing each piece of
+     * Work twice.
      */
     class Threadpool : public Worker
     {
     public:
+        /** \brief The priority of Work.
+         */
+        using Priority = unsigned int;
+
         /** \brief Construct a Threadpool with \p threads threads
          *
          * \param [in] threads
@@ -28,6 +39,32 @@ namespace bureaucracy
          */
         explicit Threadpool(std::size_t threads);
 
+        /** \brief Construct a Threadpool with priority lanes
+         *
+         * If the single-argument version of add is used (e.g., the one
+         * provided as part of Worker) the Work will be treated with priority
+         * \p defaultPriority.
+         *
+         * \param [in] threads
+         *      the number of threads to use
+         *
+         * \param [in] defaultPriority
+         *      the Priority to use if one is not specified in add
+         *
+         * \param [in] lanes
+         *      the number of Priorities; valid Priorities are in the range
+         *      [0, \p lanes)
+         *
+         * \exception std::invalid_argument
+         *      \p threads or \p lanes is 0, or \p defaultPriority is not less
+         *      than \p lanes
+         *
+         * \exception std::exception
+         *      an exception was emitted from the standard library
+         */
+        Threadpool(std::size_t threads, Priority defaultPriority,
+                   Priority lanes);
+
         /** \brief Add Work to the end of the queue
          *
          * \param [in] work
@@ -41,6 +78,73 @@ namespace bureaucracy
          */
         void add(Work work) override;
 
+        /** \brief Add Work with a Priority
+         *
+         * Smaller Priority values are considered more important than larger
+         * Priority values (e.g., Priority 0 Work will be invoked before
+         * Priority 1 Work).
+         *
+         * \param [in] work
+         *      a piece of Work to execute
+         *
+         * \param [in] priority
+         *      the Priority of \p work
+         *
+         * \exception std::invalid_argument
+         *      \p priority is not less than the number of lanes
+         *
+         * \exception std::runtime_error
+         *      the Threadpool is not accepting Work
+         *
+         * \exception std::exception
+         *      The standard library may emit exceptions.
+         */
+        void add(Work work, Priority priority);
+
+        /** \brief Add Work that can be cancelled while it's queued
+         *
+         * If \p token is cancelled before a thread reaches \p work, \p work
+         * is skipped instead of executed.  \p work can also poll \p token
+         * while it runs.  Cancelled Work stays queued until a thread reaches
+         * it.
+         *
+         * \param [in] work
+         *      a piece of Work to execute
+         *
+         * \param [in] token
+         *      the CancellationToken that can revoke \p work
+         *
+         * \exception std::runtime_error
+         *      the Threadpool is not accepting Work
+         *
+         * \exception std::exception
+         *      The standard library may emit exceptions.
+         */
+        void add(Work work, CancellationToken token);
+
+        /** \brief Add Work with a Priority that can be cancelled while it's
+         *         queued
+         *
+         * \param [in] work
+         *      a piece of Work to execute
+         *
+         * \param [in] priority
+         *      the Priority of \p work
+         *
+         * \param [in] token
+         *      the CancellationToken that can revoke \p work
+         *
+         * \exception std::invalid_argument
+         *      \p priority is not less than the number of lanes
+         *
+         * \exception std::runtime_error
+         *      the Threadpool is not accepting Work
+         *
+         * \exception std::exception
+         *      The standard library may emit exceptions.
+         */
+        void add(Work work, Priority priority, CancellationToken token);
+
         void stop() override;
 
         bool isAccepting() const noexcept override;
@@ -58,6 +162,8 @@ namespace bureaucracy
 
     private:
         ThreadpoolBase my_threadpool;
+
+        Priority const my_defaultPriority;
     };
 } // namespace bureaucracy
 
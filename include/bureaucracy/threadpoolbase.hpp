@@ -2,6 +2,7 @@
 #define BUREAUCRACY_THREADPOOLBASE_HPP 1
 
 #include <condition_variable>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -23,9 +24,9 @@ namespace bureaucracy
     class ThreadpoolBase
     {
     public:
-        explicit ThreadpoolBase(std::size_t maxThreads);
+        explicit ThreadpoolBase(std::size_t maxThreads, std::size_t lanes = 1);
 
-        void add(Worker::Work work);
+        void add(Worker::Work work, std::size_t lane = 0);
 
         void stop();
 
@@ -42,6 +43,8 @@ namespace bureaucracy
 
         std::size_t getAllocatedThreads() const noexcept;
 
+        std::size_t getLanes() const noexcept;
+
         ~ThreadpoolBase() noexcept;
         ThreadpoolBase(ThreadpoolBase const &);
         ThreadpoolBase(ThreadpoolBase &&) noexcept;
@@ -49,8 +52,17 @@ namespace bureaucracy
         ThreadpoolBase & operator=(ThreadpoolBase &&) noexcept;
 
     private:
+        void runThread();
+
+        Worker::Work takeNext();
+
         std::vector<std::thread> my_threads;
-        std::vector<Worker::Work> my_work;
+
+        // One queue per priority; threads always take from the lowest
+        // numbered lane that has Work.
+        std::vector<std::deque<Worker::Work>> my_lanes;
+        std::size_t my_firstLane;
+        std::size_t my_queued;
 
         std::condition_variable my_workReady;
         mutable std::mutex my_mutex;
@@ -63,7 +75,7 @@ namespace bureaucracy
     inline void ThreadpoolBase::addThreadIf(PREDICATE const & pred)
     {
         houseguest::synchronize(my_mutex, [this, &pred]() {
-            if(pred(my_work, my_threads))
+            if(pred(my_queued, my_threads))
             {
                 addThread();
             }
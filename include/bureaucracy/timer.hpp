@@ -1,6 +1,7 @@
 #ifndef BUREAUCRACY_TIMER_HPP
 #define BUREAUCRACY_TIMER_HPP 1
 
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -10,9 +11,11 @@
 
 namespace bureaucracy
 {
+    class ManualClock;
+
     /** \brief A class that triggers Events at certain times.
      *
-     * A Timer manages a list of Events that should be fired at specific
+     * A Timer manages a schedule of Events that should be fired at specific
      * times.  Timer will invoke an Event as close to the requested time as
      * possible but makes no guarantees regarding the level of precision or
      * delta.
@@ -21,9 +24,15 @@ namespace bureaucracy
      *          the chrono library.  This should be sufficient for most uses
      *          but projects that require precise timing should use a
      *          different timer implementation.
+     *
+     * A Timer normally follows `std::chrono::steady_clock` and fires Events
+     * from its own thread.  A Timer constructed with a ManualClock instead
+     * follows that clock and fires Events from the thread that advances it.
      */
     class Timer
     {
+        friend class ManualClock;
+
     public:
         /// \brief An Item added to a Timer.
         class Item
@@ -62,8 +71,8 @@ namespace bureaucracy
             Item(Timer * timer, Id id);
 
         private:
-            Timer * const my_timer;
-            Id const my_id;
+            Timer * my_timer;
+            Id my_id;
         };
 
         /** \brief A function a Timer can invoke.
@@ -81,6 +90,18 @@ namespace bureaucracy
         /// \brief Construct a Timer
         Timer();
 
+        /** \brief Construct a Timer driven by a ManualClock.
+         *
+         * The Timer does not spawn a thread.  Events are fired from whatever
+         * thread advances \p clock, before the call to advance returns.
+         *
+         * \param [in] clock
+         *      the clock that determines the current time
+         *
+         * \warning \p clock must outlive this Timer.
+         */
+        explicit Timer(ManualClock & clock);
+
         /** \brief Add an Event that fires at a specific time.
          *
          * Add \p event to the Timer and invoke it as close to \p due as
@@ -132,6 +153,33 @@ namespace bureaucracy
         template <typename... ARGS>
         Item add(Event event, std::chrono::duration<ARGS...> delay);
 
+        /** \brief Add several Events at once.
+         *
+         * Each element in the range [\p first, \p last) must provide the
+         * Event as `first` and its due Time as `second` (e.g., a
+         * `std::pair<Event, Time>`).  The Events are merged into the schedule
+         * in one pass under a single lock, and the Timer is woken at most
+         * once, so this is much cheaper than calling add for each Event.
+         * Events with the same due time fire in the order they appear in the
+         * range.
+         *
+         * \param [in] first
+         *      the beginning of the range of Events to add
+         *
+         * \param [in] last
+         *      the end of the range of Events to add
+         *
+         * \return an Item for each Event, in the same order as the range
+         *
+         * \exception std::runtime_error
+         *      the Timer is not accepting Events
+         *
+         * \note Elements are copied out of the range; use
+         *       `std::make_move_iterator` to move them instead.
+         */
+        template <typename ITERATOR>
+        std::vector<Item> addBatch(ITERATOR first, ITERATOR last);
+
         /** \brief Stop accepting Events and terminate the Timer thread
          *
          * \note Any scheduled Events will _not_ be called.
@@ -157,12 +205,22 @@ namespace bureaucracy
          */
         bool isRunning() const noexcept;
 
+        /** \brief Retrieve the current time according to this Timer's clock.
+         *
+         * \return the current time
+         */
+        Time now() const noexcept;
+
         /** \brief Cancel an Item if possible.
          *
          * This can fail if:
          *   * this Item is current firing
          *   * this Item is queued to fire (i.e., its delay has expired and
          *     has already been flagged for processing)
+         *   * this Item has already fired or been cancelled
+         *
+         * Each Item remembers its position in the Timer's schedule, so
+         * cancelling takes logarithmic time.
          *
          * \retval CancelStatus::cancelled
          *      This Item was cancelled successfully.
@@ -181,37 +239,53 @@ namespace bureaucracy
         /// \endcond
 
     private:
+        struct PendingEvent
+        {
+            Event fn;
+            Time due;
+        };
+
+        std::vector<Item> addEvents(std::vector<PendingEvent> events);
+
+        Item::Id nextId();
+
+        bool fireExpired(std::unique_lock<std::mutex> & lock);
+
+        void tick();
+
+        Time nextDue() const;
+
+        ManualClock * const my_clock;
+
         std::thread my_timerThread;
         mutable std::mutex my_mutex;
         std::condition_variable my_wakeup;
 
-        std::unordered_map<Item::Id, Event> my_events;
-
-        struct FutureEvent
+        struct Entry
         {
-            Item::Id event;
-            Time due;
+            Event fn;
+            std::size_t index;
         };
 
-        using FutureEvents = std::vector<FutureEvent>;
-        FutureEvents my_futureEvents;
+        // Entries live in a node-based container so the heap can point at
+        // them and keep their index current as nodes move.
+        std::unordered_map<Item::Id, Entry> my_events;
 
-        struct PendingEvent
+        struct HeapNode
         {
-            Item::Id event;
             Time due;
-            Event fn;
+            Item::Id id;
+            Entry * entry;
         };
 
-        std::vector<PendingEvent> my_pendingEvents;
+        std::vector<HeapNode> my_schedule;
 
-        FutureEvents::iterator my_nextFuture;
+        std::vector<Event> my_firing;
 
         Item::Id my_nextId;
 
         bool my_isAccepting;
         bool my_isRunning;
-        bool my_isFiring;
     };
 
     template <typename CLOCK>
@@ -226,7 +300,20 @@ namespace bureaucracy
     inline Timer::Item Timer::add(Event event,
                                   std::chrono::duration<ARGS...> delay)
     {
-        return add(std::move(event), std::chrono::steady_clock::now() + delay);
+        return add(std::move(event), now() + delay);
+    }
+
+    template <typename ITERATOR>
+    inline std::vector<Timer::Item> Timer::addBatch(ITERATOR first,
+                                                    ITERATOR last)
+    {
+        std::vector<PendingEvent> events;
+        std::for_each(first, last, [&events](auto && entry) {
+            events.emplace_back(
+                PendingEvent{std::forward<decltype(entry)>(entry).first,
+                             std::forward<decltype(entry)>(entry).second});
+        });
+        return addEvents(std::move(events));
     }
 } // namespace bureaucracy
 
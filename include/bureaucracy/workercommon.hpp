@@ -1,9 +1,12 @@
 #ifndef BUREAUCRACY_WORKERCOMMON_HPP
 #define BUREAUCRACY_WORKERCOMMON_HPP 1
 
+#include <chrono>
 #include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <limits>
 #include <mutex>
-#include <vector>
 
 #include <bureaucracy/worker.hpp>
 
@@ -29,7 +32,16 @@ namespace bureaucracy
 
         void addDirect(Worker::Work work);
 
-        void executeAll() noexcept;
+        bool startDrain(std::size_t maxDrains = 1) noexcept;
+
+        bool executeNext() noexcept;
+
+        bool executeAll(
+            std::size_t maxItems = 0,
+            std::chrono::steady_clock::duration timeSlice =
+                std::chrono::steady_clock::duration::zero()) noexcept;
+
+        bool requeue(Worker::Work const & work) noexcept;
 
         void stop();
 
@@ -49,11 +61,12 @@ namespace bureaucracy
         std::condition_variable my_isEmpty;
         mutable std::mutex my_mutex;
 
-        using WorkQueue = std::vector<DATA>;
+        using WorkQueue = std::deque<DATA>;
         WorkQueue my_work;
 
         bool my_isAccepting;
         bool my_isRunning;
+        std::size_t my_drains;
     };
 
     template <typename DATA>
@@ -61,6 +74,7 @@ namespace bureaucracy
       : my_worker{&worker}
       , my_isAccepting{true}
       , my_isRunning{true}
+      , my_drains{0}
     {
     }
 
@@ -95,21 +109,113 @@ namespace bureaucracy
     }
 
     template <typename DATA>
-    inline void WorkerCommon<DATA>::executeAll() noexcept
+    inline bool WorkerCommon<DATA>::startDrain(std::size_t maxDrains) noexcept
     {
-        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
-            while(!my_work.empty())
+        // should be locked
+        if(my_drains < maxDrains)
+        {
+            ++my_drains;
+            return true;
+        }
+        return false;
+    }
+
+    template <typename DATA>
+    inline bool WorkerCommon<DATA>::executeNext() noexcept
+    {
+        // Run a single piece of Work so several drains can share the queue.
+        // Returns false, ending the drain, once the queue is empty.
+        return houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            if(my_work.empty())
             {
-                auto nextItem = my_work.front();
-                my_work.erase(std::begin(my_work));
+                --my_drains;
+                my_isEmpty.notify_all();
+                return false;
+            }
+            auto next = std::move(my_work.front());
+            my_work.pop_front();
+            lock.unlock();
+            next();
+            return true;
+        });
+    }
+
+    template <typename DATA>
+    inline bool WorkerCommon<DATA>::executeAll(
+        std::size_t maxItems,
+        std::chrono::steady_clock::duration timeSlice) noexcept
+    {
+        // a budget of 0 means unlimited
+        using Clock = std::chrono::steady_clock;
+        auto const hasDeadline = timeSlice > Clock::duration::zero();
+        auto const deadline =
+            hasDeadline ? Clock::now() + timeSlice : Clock::time_point::max();
+        auto remaining = (maxItems == 0)
+                             ? std::numeric_limits<std::size_t>::max()
+                             : maxItems;
+        auto const outOfBudget = [hasDeadline, deadline, &remaining]() {
+            --remaining;
+            return (remaining == 0) ||
+                   (hasDeadline && !(Clock::now() < deadline));
+        };
+
+        return houseguest::synchronize_unique(my_mutex, [this, &outOfBudget](
+                                                            auto lock) {
+            // Take everything queued in one go and run it without the lock,
+            // then check once for anything that arrived in the meantime.
+            // The two queues trade places so their storage is reused.
+            WorkQueue batch;
+            auto exhausted = false;
+            while(!exhausted && !my_work.empty())
+            {
+                batch.swap(my_work);
                 lock.unlock();
-                nextItem();
+                auto it = std::begin(batch);
+                auto const end = std::end(batch);
+                while(!exhausted && (it != end))
+                {
+                    (*it)();
+                    ++it;
+                    exhausted = outOfBudget();
+                }
                 lock.lock();
+                if(it != end)
+                {
+                    // Out of budget; whatever's left goes back in front of
+                    // Work that arrived while the batch was running.
+                    my_work.insert(std::begin(my_work),
+                                   std::make_move_iterator(it),
+                                   std::make_move_iterator(end));
+                }
+                batch.clear();
             }
-            my_isEmpty.notify_one();
+            if(my_work.empty())
+            {
+                --my_drains;
+                my_isEmpty.notify_all();
+                return false;
+            }
+            // still draining; the caller has to schedule the rest
+            return true;
         });
     }
 
+    template <typename DATA>
+    inline bool WorkerCommon<DATA>::requeue(Worker::Work const & work) noexcept
+    {
+        // Deliberately skips the isAccepting check: a drain that's already
+        // running has to finish even if stop was called.
+        try
+        {
+            my_worker->add(work);
+            return true;
+        }
+        catch(...)
+        {
+            return false;
+        }
+    }
+
     template <typename DATA>
     inline void WorkerCommon<DATA>::stop()
     {
@@ -117,10 +223,9 @@ namespace bureaucracy
             if(my_isAccepting)
             {
                 my_isAccepting = false;
-                if(!my_work.empty())
-                {
-                    my_isEmpty.wait(lock);
-                }
+                my_isEmpty.wait(lock, [this]() {
+                    return my_work.empty() && (my_drains == 0);
+                });
                 my_isRunning = false;
             }
         });
@@ -141,8 +246,8 @@ namespace bureaucracy
     inline DATA WorkerCommon<DATA>::getNextItem() noexcept
     {
         return houseguest::synchronize(my_mutex, [this]() {
-            auto ret = my_work.front();
-            my_work.erase(std::begin(my_work));
+            auto ret = std::move(my_work.front());
+            my_work.pop_front();
             return ret;
         });
     }
@@ -0,0 +1,75 @@
+#include <bureaucracy/manualclock.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+#include <bureaucracy/timer.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::ManualClock;
+
+ManualClock::ManualClock(time_point start)
+  : my_now{start.time_since_epoch().count()}
+{
+}
+
+ManualClock::time_point ManualClock::now() const noexcept
+{
+    return time_point{duration{my_now.load()}};
+}
+
+void ManualClock::advance(duration delta)
+{
+    advanceTo(now() + std::max(delta, duration::zero()));
+}
+
+void ManualClock::advanceTo(time_point time)
+{
+    houseguest::synchronize(my_mutex, [this, time]() {
+        auto const tickAll = [this]() {
+            std::for_each(std::begin(my_timers), std::end(my_timers),
+                          [](auto timer) { timer->tick(); });
+        };
+
+        // Step through each due time so Events observe the time they were
+        // scheduled for rather than the final time.
+        while(true)
+        {
+            auto const nextDue = std::accumulate(
+                std::begin(my_timers), std::end(my_timers), time_point::max(),
+                [](auto current, auto timer) {
+                    return std::min(current, timer->nextDue());
+                });
+            if((nextDue == time_point::max()) || (time < nextDue))
+            {
+                break;
+            }
+            if(now() < nextDue)
+            {
+                my_now = nextDue.time_since_epoch().count();
+            }
+            tickAll();
+        }
+        if(now() < time)
+        {
+            my_now = time.time_since_epoch().count();
+        }
+        tickAll();
+    });
+}
+
+void ManualClock::attach(Timer * timer)
+{
+    houseguest::synchronize(my_mutex,
+                            [this, timer]() { my_timers.push_back(timer); });
+}
+
+void ManualClock::detach(Timer * timer)
+{
+    houseguest::synchronize(my_mutex, [this, timer]() {
+        my_timers.erase(
+            std::remove(std::begin(my_timers), std::end(my_timers), timer),
+            std::end(my_timers));
+    });
+}
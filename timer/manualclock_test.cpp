@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <bureaucracy/manualclock.hpp>
+#include <bureaucracy/shardedtimer.hpp>
+#include <bureaucracy/timer.hpp>
+
+using bureaucracy::ManualClock;
+using bureaucracy::ShardedTimer;
+using bureaucracy::Timer;
+
+TEST(ManualClock, test_ctor) // NOLINT
+{
+    auto const start = ManualClock::time_point{std::chrono::hours(1)};
+    ManualClock clock{start};
+
+    ASSERT_EQ(start, clock.now());
+}
+
+TEST(ManualClock, test_advance) // NOLINT
+{
+    ManualClock clock;
+
+    clock.advance(std::chrono::seconds(5));
+    ASSERT_EQ(ManualClock::time_point{std::chrono::seconds(5)}, clock.now());
+}
+
+TEST(ManualClock, test_advanceBackwards) // NOLINT
+{
+    ManualClock clock{ManualClock::time_point{std::chrono::seconds(5)}};
+
+    clock.advance(std::chrono::seconds(-1));
+    clock.advanceTo(ManualClock::time_point{std::chrono::seconds(1)});
+    ASSERT_EQ(ManualClock::time_point{std::chrono::seconds(5)}, clock.now());
+}
+
+TEST(ManualClock, test_timerCtor) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    ASSERT_EQ(true, t.isAccepting());
+    ASSERT_EQ(true, t.isRunning());
+    ASSERT_EQ(clock.now(), t.now());
+}
+
+TEST(ManualClock, test_timerStop) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    auto hit = false;
+    t.add([&hit]() { hit = true; }, std::chrono::seconds(1));
+    t.stop();
+    ASSERT_EQ(false, t.isAccepting());
+    ASSERT_EQ(false, t.isRunning());
+
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_EQ(false, hit);
+}
+
+TEST(ManualClock, test_timerFire) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    auto hit = false;
+    t.add([&hit]() { hit = true; }, std::chrono::hours(1));
+
+    clock.advance(std::chrono::minutes(59));
+    ASSERT_EQ(false, hit);
+    clock.advance(std::chrono::minutes(1));
+    ASSERT_EQ(true, hit);
+}
+
+TEST(ManualClock, test_timerSequence) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    std::vector<int> fired;
+    t.add([&fired]() { fired.push_back(2); }, std::chrono::seconds(2));
+    t.add([&fired]() { fired.push_back(0); }, std::chrono::seconds(0));
+    t.add([&fired]() { fired.push_back(1); }, std::chrono::seconds(1));
+
+    clock.advance(std::chrono::hours(1));
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), fired);
+}
+
+TEST(ManualClock, test_timerEventTime) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    std::vector<ManualClock::time_point> fired;
+    t.add(
+        [&t, &fired]() {
+            fired.push_back(t.now());
+            t.add([&t, &fired]() { fired.push_back(t.now()); },
+                  std::chrono::seconds(10));
+        },
+        std::chrono::seconds(10));
+
+    clock.advance(std::chrono::hours(1));
+    ASSERT_EQ((std::vector<ManualClock::time_point>{
+                  ManualClock::time_point{std::chrono::seconds(10)},
+                  ManualClock::time_point{std::chrono::seconds(20)}}),
+              fired);
+}
+
+TEST(ManualClock, test_timerCancel) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    auto hit = false;
+    auto item = t.add([&hit]() { hit = true; }, std::chrono::seconds(1));
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, t.cancel(item));
+
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_EQ(false, hit);
+}
+
+TEST(ManualClock, test_timerMany) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    auto constexpr count = 10000;
+    auto hits = 0;
+    for(auto i = 0; i < count; ++i)
+    {
+        t.add([&hits]() { ++hits; }, std::chrono::seconds(i));
+    }
+
+    clock.advance(std::chrono::seconds(count / 2 - 1));
+    ASSERT_EQ(count / 2, hits);
+    clock.advance(std::chrono::hours(24));
+    ASSERT_EQ(count, hits);
+}
+
+TEST(ManualClock, test_shardedTimer) // NOLINT
+{
+    ManualClock clock;
+    ShardedTimer t{4, clock};
+
+    auto hit = false;
+    t.add([&hit]() { hit = true; }, std::chrono::seconds(1));
+
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_EQ(true, hit);
+}
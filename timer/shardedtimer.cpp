@@ -0,0 +1,99 @@
+#include <bureaucracy/shardedtimer.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+using bureaucracy::ShardedTimer;
+
+namespace
+{
+    std::size_t threadIndex() noexcept
+    {
+        // Hashing std::thread::id tends to produce aligned values that all
+        // land in the same shard, so hand out indices round-robin instead.
+        static std::atomic<std::size_t> nextIndex{0};
+        thread_local auto const index = nextIndex++;
+        return index;
+    }
+} // namespace
+
+ShardedTimer::ShardedTimer(std::size_t shards)
+{
+    if(shards == 0)
+    {
+        throw std::invalid_argument{"Invalid shard count"};
+    }
+    my_shards.reserve(shards);
+    for(auto i = 0u; i < shards; ++i)
+    {
+        my_shards.emplace_back(std::make_unique<Timer>());
+    }
+}
+
+ShardedTimer::ShardedTimer(std::size_t shards, ManualClock & clock)
+{
+    if(shards == 0)
+    {
+        throw std::invalid_argument{"Invalid shard count"};
+    }
+    my_shards.reserve(shards);
+    for(auto i = 0u; i < shards; ++i)
+    {
+        my_shards.emplace_back(std::make_unique<Timer>(clock));
+    }
+}
+
+/// \cond false
+ShardedTimer::~ShardedTimer() noexcept
+{
+    stop();
+}
+/// \endcond
+
+void ShardedTimer::stop()
+{
+    std::for_each(std::begin(my_shards), std::end(my_shards),
+                  [](auto & shard) { shard->stop(); });
+}
+
+bool ShardedTimer::isAccepting() const noexcept
+{
+    return std::all_of(std::begin(my_shards), std::end(my_shards),
+                       [](auto const & shard) { return shard->isAccepting(); });
+}
+
+bool ShardedTimer::isRunning() const noexcept
+{
+    return std::any_of(std::begin(my_shards), std::end(my_shards),
+                       [](auto const & shard) { return shard->isRunning(); });
+}
+
+ShardedTimer::Time ShardedTimer::now() const noexcept
+{
+    return my_shards.front()->now();
+}
+
+bureaucracy::Timer::Item::CancelStatus ShardedTimer::cancel(Item item)
+{
+    if(item.my_shard < my_shards.size())
+    {
+        return my_shards[item.my_shard]->cancel(item.my_item);
+    }
+    return Timer::Item::CancelStatus::failed;
+}
+
+std::size_t ShardedTimer::shards() const noexcept
+{
+    return my_shards.size();
+}
+
+std::size_t ShardedTimer::currentShard() const noexcept
+{
+    return threadIndex() % my_shards.size();
+}
+
+ShardedTimer::Item::Item(std::size_t shard, Timer::Item item)
+  : my_shard{shard}
+  , my_item{item}
+{
+}
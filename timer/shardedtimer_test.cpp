@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include <bureaucracy/shardedtimer.hpp>
+
+using bureaucracy::ShardedTimer;
+using bureaucracy::Timer;
+
+TEST(ShardedTimer, test_ctor) // NOLINT
+{
+    ShardedTimer t{4};
+    ASSERT_EQ(true, t.isAccepting());
+    ASSERT_EQ(true, t.isRunning());
+    ASSERT_EQ(4, t.shards());
+}
+
+TEST(ShardedTimer, test_stop) // NOLINT
+{
+    ShardedTimer t{4};
+
+    t.stop();
+    ASSERT_EQ(false, t.isAccepting());
+    ASSERT_EQ(false, t.isRunning());
+}
+
+TEST(ShardedTimer, test_addDelay) // NOLINT
+{
+    ShardedTimer t{4};
+
+    std::promise<void> hit;
+    t.add([&hit]() { hit.set_value(); }, std::chrono::milliseconds(100));
+
+    hit.get_future().get();
+}
+
+TEST(ShardedTimer, test_addDue) // NOLINT
+{
+    ShardedTimer t{4};
+
+    std::promise<void> hit;
+    t.add([&hit]() { hit.set_value(); },
+          std::chrono::system_clock::now() + std::chrono::milliseconds(100));
+
+    hit.get_future().get();
+}
+
+TEST(ShardedTimer, test_addThreads) // NOLINT
+{
+    ShardedTimer t{2};
+
+    std::promise<void> hit1;
+    std::promise<void> hit2;
+    std::thread adder{[&t, &hit1]() {
+        t.add([&hit1]() { hit1.set_value(); }, std::chrono::milliseconds(100));
+    }};
+    t.add([&hit2]() { hit2.set_value(); }, std::chrono::milliseconds(100));
+    adder.join();
+
+    hit1.get_future().get();
+    hit2.get_future().get();
+}
+
+TEST(ShardedTimer, test_cancelNormal) // NOLINT
+{
+    ShardedTimer t{4};
+
+    auto item = t.add([]() {}, std::chrono::milliseconds(100));
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, t.cancel(item));
+}
+
+TEST(ShardedTimer, test_cancelOtherThread) // NOLINT
+{
+    ShardedTimer t{4};
+
+    auto item = t.add([]() {}, std::chrono::seconds(100));
+    auto cancelStatus = Timer::Item::CancelStatus::failed;
+    std::thread canceller{
+        [&t, item, &cancelStatus]() { cancelStatus = t.cancel(item); }};
+    canceller.join();
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, cancelStatus);
+}
+
+TEST(ShardedTimer, test_cancelFailed) // NOLINT
+{
+    ShardedTimer t{4};
+
+    std::promise<void> hit;
+    auto item =
+        t.add([&hit]() { hit.set_value(); }, std::chrono::milliseconds(100));
+
+    hit.get_future().get();
+    ASSERT_EQ(Timer::Item::CancelStatus::failed, t.cancel(item));
+}
+
+TEST(NegativeShardedTimer, test_invalidShardCount) // NOLINT
+{
+    ASSERT_THROW(ShardedTimer{0}, std::invalid_argument);
+}
+
+TEST(NegativeShardedTimer, test_addPostStop) // NOLINT
+{
+    ShardedTimer t{4};
+
+    t.stop();
+    auto addFn = [&t]() { t.add([]() {}, std::chrono::milliseconds(0)); };
+    ASSERT_THROW(addFn(), std::runtime_error);
+}
@@ -1,77 +1,69 @@
 #include <bureaucracy/timer.hpp>
 
 #include <algorithm>
-#include <cassert>
+
+#include <bureaucracy/indexedheap.hpp>
+#include <bureaucracy/manualclock.hpp>
 
 #include <houseguest/synchronize.hpp>
 
 using bureaucracy::Timer;
 
+namespace
+{
+    struct IsEarlier
+    {
+        template <typename NODE>
+        bool operator()(NODE const & lhs, NODE const & rhs) const noexcept
+        {
+            // ids increase as Events are added, so ties fire in the order
+            // they were added
+            return (lhs.due < rhs.due) ||
+                   ((lhs.due == rhs.due) && (lhs.id < rhs.id));
+        }
+    };
+
+    // The schedule is a 4-ary min-heap.  It's shallower than a binary heap
+    // and a node's children sit next to each other in memory, so adds and
+    // pops touch fewer cache lines.
+    constexpr std::size_t heapArity = 4;
+
+    using Schedule = bureaucracy::IndexedHeap<heapArity, IsEarlier>;
+} // namespace
+
 Timer::Timer()
-  : my_nextFuture{my_futureEvents.end()}
+  : my_clock{nullptr}
   , my_nextId{0}
   , my_isAccepting{true}
   , my_isRunning{true}
-  , my_isFiring{false}
 {
     my_timerThread = std::thread{[this]() {
         std::unique_lock<std::mutex> lock{my_mutex};
 
         while(my_isAccepting)
         {
-            if(my_futureEvents.empty())
+            if(my_schedule.empty())
             {
                 my_wakeup.wait(lock);
             }
-            else
+            else if(!fireExpired(lock))
             {
-                auto const now = std::chrono::steady_clock::now();
-                auto begin = std::begin(my_futureEvents);
-                auto const end = std::end(my_futureEvents);
-                auto last = std::find_if(begin, end, [now](auto const & event) {
-                    return now < event.due;
-                });
-                if(begin != last)
-                {
-                    my_isFiring = true;
-                    my_nextFuture = last;
-                    lock.unlock();
-                    std::for_each(begin, last, [this](auto & futureEvent) {
-                        auto it = my_events.find(futureEvent.event);
-                        assert(it != my_events.end());
-                        it->second();
-                        my_events.erase(it);
-                    });
-                    lock.lock();
-                    my_isFiring = false;
-                    my_futureEvents.erase(begin, last);
-                    my_nextFuture = my_futureEvents.begin();
-                    std::for_each(
-                        std::begin(my_pendingEvents),
-                        std::end(my_pendingEvents), [this](auto & event) {
-                            auto it = std::find_if(
-                                std::begin(my_futureEvents),
-                                std::end(my_futureEvents),
-                                [&event](auto const & futureEvent) {
-                                    return event.due < futureEvent.due;
-                                });
-                            my_futureEvents.emplace(
-                                it, FutureEvent{event.event, event.due});
-                            my_events.emplace(event.event, std::move(event.fn));
-                        });
-                    my_pendingEvents.erase(std::begin(my_pendingEvents),
-                                           std::end(my_pendingEvents));
-                }
-                else
-                {
-                    auto alarm = (*begin).due;
-                    my_wakeup.wait_until(lock, alarm);
-                }
+                auto alarm = my_schedule.front().due;
+                my_wakeup.wait_until(lock, alarm);
             }
         }
     }};
 }
 
+Timer::Timer(ManualClock & clock)
+  : my_clock{&clock}
+  , my_nextId{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+    my_clock->attach(this);
+}
+
 /// \cond false
 Timer::~Timer() noexcept
 {
@@ -84,33 +76,14 @@ Timer::Item Timer::add(Event event, Time due)
     return houseguest::synchronize(my_mutex, [this, &event, &due]() {
         if(my_isAccepting)
         {
-            auto id = [this]() {
-                auto ret = my_nextId;
-                auto it = my_events.find(ret);
-                while(it != my_events.end())
-                {
-                    ++ret;
-                    it = my_events.find(ret);
-                }
-                my_nextId = ret + 1;
-                return ret;
-            }();
-
-            if(my_isFiring)
+            auto const id = nextId();
+            auto inserted = my_events.emplace(id, Entry{std::move(event), 0});
+            auto & entry = inserted.first->second;
+            my_schedule.emplace_back(HeapNode{due, id, &entry});
+            Schedule::siftUp(my_schedule, my_schedule.size() - 1);
+            if(entry.index == 0)
             {
-                my_pendingEvents.emplace_back(
-                    PendingEvent{id, due, std::move(event)});
-            }
-            else
-            {
-                auto it = std::find_if(std::begin(my_futureEvents),
-                                       std::end(my_futureEvents),
-                                       [due](auto const & currentEvent) {
-                                           return due < currentEvent.due;
-                                       });
-                my_futureEvents.emplace(it, FutureEvent{id, due});
-                my_events.emplace(id, std::move(event));
-                my_nextFuture = std::begin(my_futureEvents);
+                // only wake the timer thread if its alarm changed
                 my_wakeup.notify_one();
             }
             return Item{this, id};
@@ -119,6 +92,59 @@ Timer::Item Timer::add(Event event, Time due)
     });
 }
 
+std::vector<Timer::Item> Timer::addEvents(std::vector<PendingEvent> events)
+{
+    return houseguest::synchronize(my_mutex, [this, &events]() {
+        if(!my_isAccepting)
+        {
+            throw std::runtime_error{"Not accepting"};
+        }
+
+        auto const oldSize = my_schedule.size();
+        auto const oldFront = (oldSize == 0) ? nullptr
+                                             : my_schedule.front().entry;
+        my_schedule.reserve(oldSize + events.size());
+
+        std::vector<Item> items;
+        items.reserve(events.size());
+        std::for_each(std::begin(events), std::end(events),
+                      [this, &items](auto & event) {
+                          auto const id = nextId();
+                          auto inserted = my_events.emplace(
+                              id, Entry{std::move(event.fn), 0});
+                          auto & entry = inserted.first->second;
+                          my_schedule.emplace_back(
+                              HeapNode{event.due, id, &entry});
+                          entry.index = my_schedule.size() - 1;
+                          items.emplace_back(Item{this, id});
+                      });
+
+        if(events.size() > oldSize)
+        {
+            // Rebuilding the whole heap is linear, which beats sifting each
+            // new node up when the batch dominates the schedule.
+            for(auto index = my_schedule.size() / heapArity + 1; index > 0;
+                --index)
+            {
+                Schedule::siftDown(my_schedule, index - 1);
+            }
+        }
+        else
+        {
+            for(auto index = oldSize; index < my_schedule.size(); ++index)
+            {
+                Schedule::siftUp(my_schedule, index);
+            }
+        }
+
+        if(!my_schedule.empty() && (my_schedule.front().entry != oldFront))
+        {
+            my_wakeup.notify_one();
+        }
+        return items;
+    });
+}
+
 void Timer::stop()
 {
     houseguest::synchronize_unique(my_mutex, [this](auto lock) {
@@ -127,7 +153,14 @@ void Timer::stop()
             my_isAccepting = false;
             my_wakeup.notify_one();
             lock.unlock();
-            my_timerThread.join();
+            if(my_clock != nullptr)
+            {
+                my_clock->detach(this);
+            }
+            else
+            {
+                my_timerThread.join();
+            }
             lock.lock();
             my_isRunning = false;
         }
@@ -145,46 +178,91 @@ bool Timer::isRunning() const noexcept
     return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
 }
 
+Timer::Time Timer::now() const noexcept
+{
+    if(my_clock != nullptr)
+    {
+        return my_clock->now();
+    }
+    return std::chrono::steady_clock::now();
+}
+
 Timer::Item::CancelStatus Timer::cancel(Timer::Item item)
 {
     return houseguest::synchronize(my_mutex, [this, &item]() {
-        // If we're firing, check the pending events since they haven't been
-        // merged in yet.
-        if(my_isFiring)
+        // Events that are firing (or about to) have already been removed, so
+        // anything still in my_events can be cancelled.
+        auto it = my_events.find(item.my_id);
+        if(it != my_events.end())
         {
-            auto const pendingEnd = std::end(my_pendingEvents);
-            auto const pendingIt =
-                std::find_if(std::begin(my_pendingEvents), pendingEnd,
-                             [id = item.my_id](auto const & pendingEvent) {
-                                 return pendingEvent.event == id;
-                             });
-            if(pendingIt != pendingEnd)
-            {
-                my_pendingEvents.erase(pendingIt);
-                return Timer::Item::CancelStatus::cancelled;
-            }
-            return Timer::Item::CancelStatus::failed;
+            Schedule::removeAt(my_schedule, it->second.index);
+            my_events.erase(it);
+            return Timer::Item::CancelStatus::cancelled;
         }
-        else
+        return Timer::Item::CancelStatus::failed;
+    });
+}
+
+Timer::Item::Id Timer::nextId()
+{
+    // should be locked
+    auto ret = my_nextId;
+    auto it = my_events.find(ret);
+    while(it != my_events.end())
+    {
+        ++ret;
+        it = my_events.find(ret);
+    }
+    my_nextId = ret + 1;
+    return ret;
+}
+
+bool Timer::fireExpired(std::unique_lock<std::mutex> & lock)
+{
+    // should be locked
+    auto const now = this->now();
+    while(!my_schedule.empty() && !(now < my_schedule.front().due))
+    {
+        auto const id = my_schedule.front().id;
+        my_firing.emplace_back(std::move(my_schedule.front().entry->fn));
+        Schedule::removeAt(my_schedule, 0);
+        my_events.erase(id);
+    }
+    if(my_firing.empty())
+    {
+        return false;
+    }
+
+    // Only one thread fires a given Timer at a time (the timer thread or the
+    // thread advancing its ManualClock), so my_firing is safe to use without
+    // the lock.
+    lock.unlock();
+    std::for_each(std::begin(my_firing), std::end(my_firing),
+                  [](auto const & event) { event(); });
+    my_firing.clear();
+    lock.lock();
+    return true;
+}
+
+void Timer::tick()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        // Events fired here may add Events that are already due, so keep
+        // going until nothing expired remains.
+        while(my_isAccepting && fireExpired(lock))
         {
-            // If we're not firing, then the other queues can be checked
-            auto const end = std::end(my_futureEvents);
-            auto futureIt =
-                std::find_if(my_nextFuture, end,
-                             [id = item.my_id](auto const & futureEvent) {
-                                 return futureEvent.event == id;
-                             });
-            if(futureIt != end)
-            {
-                my_futureEvents.erase(futureIt);
-                my_events.erase(item.my_id);
-                return Timer::Item::CancelStatus::cancelled;
-            }
+        }
+    });
+}
 
-            // At this point, we didn't find the item in either queue.  It's
-            // either an invalid id or queued to fire.
-            return Timer::Item::CancelStatus::failed;
+Timer::Time Timer::nextDue() const
+{
+    return houseguest::synchronize(my_mutex, [this]() {
+        if(!my_isAccepting || my_schedule.empty())
+        {
+            return Time::max();
         }
+        return my_schedule.front().due;
     });
 }
 
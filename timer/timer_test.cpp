@@ -1,9 +1,12 @@
 #include <gtest/gtest.h>
 
 #include <future>
+#include <vector>
 
+#include <bureaucracy/manualclock.hpp>
 #include <bureaucracy/timer.hpp>
 
+using bureaucracy::ManualClock;
 using bureaucracy::Timer;
 
 TEST(Timer, test_ctor) // NOLINT
@@ -234,7 +237,18 @@ TEST(Timer, test_cancelFiring) // NOLINT
         std::chrono::milliseconds(100));
 
     hit.get_future().get();
-    ASSERT_EQ(Timer::Item::CancelStatus::failed, cancelStatus);
+    // item isn't due for a long time, so it can be cancelled even though
+    // another Event is firing
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, cancelStatus);
+}
+
+TEST(Timer, test_cancelTwice) // NOLINT
+{
+    Timer t;
+
+    auto item = t.add([]() {}, std::chrono::seconds(100));
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, t.cancel(item));
+    ASSERT_EQ(Timer::Item::CancelStatus::failed, t.cancel(item));
 }
 
 TEST(Timer, test_cancelPending) // NOLINT
@@ -254,3 +268,128 @@ TEST(Timer, test_cancelPending) // NOLINT
     hit.get_future().get();
     ASSERT_EQ(Timer::Item::CancelStatus::cancelled, cancelStatus);
 }
+
+TEST(Timer, test_addBatch) // NOLINT
+{
+    Timer t;
+
+    auto val = 0;
+    std::promise<void> hit;
+    auto const now = std::chrono::steady_clock::now();
+    std::vector<std::pair<Timer::Event, Timer::Time>> events{
+        {[&val, &hit]() {
+             ASSERT_EQ(10, val);
+             val = 100;
+             hit.set_value();
+         },
+         now + std::chrono::milliseconds(200)},
+        {[&val]() {
+             ASSERT_EQ(0, val);
+             val = 10;
+         },
+         now + std::chrono::milliseconds(100)}};
+
+    auto items = t.addBatch(std::begin(events), std::end(events));
+    ASSERT_EQ(2, items.size());
+
+    hit.get_future().get();
+    ASSERT_EQ(100, val);
+}
+
+TEST(Timer, test_addBatchMerge) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    std::vector<int> fired;
+    t.add([&fired]() { fired.push_back(1); }, std::chrono::seconds(2));
+    t.add([&fired]() { fired.push_back(4); }, std::chrono::seconds(5));
+
+    auto const now = clock.now();
+    std::vector<std::pair<Timer::Event, Timer::Time>> events{
+        {[&fired]() { fired.push_back(3); }, now + std::chrono::seconds(4)},
+        {[&fired]() { fired.push_back(0); }, now + std::chrono::seconds(1)},
+        {[&fired]() { fired.push_back(2); }, now + std::chrono::seconds(2)}};
+    t.addBatch(std::make_move_iterator(std::begin(events)),
+               std::make_move_iterator(std::end(events)));
+
+    clock.advance(std::chrono::seconds(10));
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 4}), fired);
+}
+
+TEST(Timer, test_addBatchCancel) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    std::vector<int> fired;
+    auto const now = clock.now();
+    std::vector<std::pair<Timer::Event, Timer::Time>> events{
+        {[&fired]() { fired.push_back(0); }, now + std::chrono::seconds(2)},
+        {[&fired]() { fired.push_back(1); }, now + std::chrono::seconds(1)}};
+    auto items = t.addBatch(std::begin(events), std::end(events));
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, t.cancel(items[1]));
+
+    clock.advance(std::chrono::seconds(10));
+    ASSERT_EQ((std::vector<int>{0}), fired);
+}
+
+TEST(Timer, test_addBatchFiring) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    std::vector<int> fired;
+    t.add(
+        [&t, &fired]() {
+            auto const now = t.now();
+            std::vector<std::pair<Timer::Event, Timer::Time>> events{
+                {[&fired]() { fired.push_back(2); },
+                 now + std::chrono::seconds(2)},
+                {[&fired]() { fired.push_back(1); },
+                 now + std::chrono::seconds(1)}};
+            t.addBatch(std::begin(events), std::end(events));
+            fired.push_back(0);
+        },
+        std::chrono::seconds(1));
+
+    clock.advance(std::chrono::seconds(10));
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), fired);
+}
+
+TEST(NegativeTimer, test_addBatchPostStop) // NOLINT
+{
+    Timer t;
+
+    t.stop();
+    std::vector<std::pair<Timer::Event, Timer::Time>> events{
+        {[]() {}, std::chrono::steady_clock::now()}};
+    ASSERT_THROW(t.addBatch(std::begin(events), std::end(events)),
+                 std::runtime_error);
+}
+
+TEST(Timer, test_scheduleOrder) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+
+    // enough Events to build a few levels of the schedule, added out of order
+    // with duplicate due times
+    auto constexpr count = 1000;
+    std::vector<int> fired;
+    std::vector<Timer::Item> items;
+    for(auto i = 0; i < count; ++i)
+    {
+        auto const due = std::chrono::seconds((i * 7919) % 97);
+        items.push_back(
+            t.add([&fired, due]() { fired.push_back(due.count()); }, due));
+    }
+    for(auto i = 0; i < count; i += 3)
+    {
+        ASSERT_EQ(Timer::Item::CancelStatus::cancelled, t.cancel(items[i]));
+    }
+
+    clock.advance(std::chrono::seconds(100));
+    ASSERT_EQ(count - (count + 2) / 3, fired.size());
+    ASSERT_TRUE(std::is_sorted(std::begin(fired), std::end(fired)));
+}
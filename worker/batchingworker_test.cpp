@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include <bureaucracy/batchingworker.hpp>
+#include <bureaucracy/manualclock.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::BatchingWorker;
+using bureaucracy::ManualClock;
+using bureaucracy::Threadpool;
+using bureaucracy::Timer;
+using bureaucracy::Worker;
+
+namespace
+{
+    // Executes Work as soon as it's added so tests can check exactly when
+    // the BatchingWorker flushes.
+    class InlineWorker : public Worker
+    {
+    public:
+        void add(Work work) override
+        {
+            work();
+        }
+
+        void stop() override
+        {
+        }
+
+        bool isAccepting() const noexcept override
+        {
+            return true;
+        }
+
+        bool isRunning() const noexcept override
+        {
+            return true;
+        }
+    };
+
+    using Batches = std::vector<std::vector<int>>;
+} // namespace
+
+TEST(BatchingWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    BatchingWorker<int> bw{tp, t, [](auto) {}, 4, std::chrono::seconds{1}};
+
+    ASSERT_EQ(true, bw.isAccepting());
+    ASSERT_EQ(true, bw.isRunning());
+}
+
+TEST(BatchingWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    BatchingWorker<int> bw{tp, t, [](auto) {}, 4, std::chrono::seconds{1}};
+
+    bw.stop();
+    ASSERT_EQ(false, bw.isAccepting());
+    ASSERT_EQ(false, bw.isRunning());
+}
+
+TEST(BatchingWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    std::promise<std::vector<int>> batch;
+    BatchingWorker<int> bw{tp, t,
+                           [&batch](auto values) {
+                               batch.set_value(std::move(values));
+                           },
+                           2, std::chrono::seconds{10}};
+
+    bw.add(1);
+    bw.add(2);
+    ASSERT_EQ((std::vector<int>{1, 2}), batch.get_future().get());
+}
+
+TEST(BatchingWorker, test_fullBatch) // NOLINT
+{
+    InlineWorker iw;
+    ManualClock clock;
+    Timer t{clock};
+    Batches batches;
+    BatchingWorker<int> bw{
+        iw, t,
+        [&batches](auto values) { batches.emplace_back(std::move(values)); },
+        3, std::chrono::seconds{1}};
+
+    for(auto i = 0; i < 7; ++i)
+    {
+        bw.add(i);
+    }
+    ASSERT_EQ((Batches{{0, 1, 2}, {3, 4, 5}}), batches);
+
+    // the full batches cancelled their alarms; only the last one is left
+    clock.advance(std::chrono::seconds{1});
+    ASSERT_EQ((Batches{{0, 1, 2}, {3, 4, 5}, {6}}), batches);
+}
+
+TEST(BatchingWorker, test_delay) // NOLINT
+{
+    InlineWorker iw;
+    ManualClock clock;
+    Timer t{clock};
+    Batches batches;
+    BatchingWorker<int> bw{
+        iw, t,
+        [&batches](auto values) { batches.emplace_back(std::move(values)); },
+        10, std::chrono::milliseconds{100}};
+
+    bw.add(1);
+    clock.advance(std::chrono::milliseconds{60});
+    bw.add(2);
+    ASSERT_EQ(true, batches.empty());
+
+    // the deadline is measured from the first value in the batch
+    clock.advance(std::chrono::milliseconds{40});
+    ASSERT_EQ((Batches{{1, 2}}), batches);
+
+    bw.add(3);
+    clock.advance(std::chrono::milliseconds{99});
+    ASSERT_EQ((Batches{{1, 2}}), batches);
+    clock.advance(std::chrono::milliseconds{1});
+    ASSERT_EQ((Batches{{1, 2}, {3}}), batches);
+}
+
+TEST(BatchingWorker, test_flush) // NOLINT
+{
+    InlineWorker iw;
+    ManualClock clock;
+    Timer t{clock};
+    Batches batches;
+    BatchingWorker<int> bw{
+        iw, t,
+        [&batches](auto values) { batches.emplace_back(std::move(values)); },
+        10, std::chrono::milliseconds{100}};
+
+    bw.flush();
+    ASSERT_EQ(true, batches.empty());
+
+    bw.add(1);
+    bw.flush();
+    ASSERT_EQ((Batches{{1}}), batches);
+
+    // the flushed batch's alarm must not flush the next batch early
+    bw.add(2);
+    clock.advance(std::chrono::milliseconds{100});
+    ASSERT_EQ((Batches{{1}, {2}}), batches);
+}
+
+TEST(BatchingWorker, test_stopFlushes) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    std::vector<int> values;
+    BatchingWorker<int> bw{tp, t,
+                           [&values](auto batch) {
+                               values.insert(values.end(), batch.begin(),
+                                             batch.end());
+                           },
+                           10, std::chrono::hours{1}};
+
+    bw.add(1);
+    bw.add(2);
+    bw.stop();
+    ASSERT_EQ((std::vector<int>{1, 2}), values);
+}
+
+TEST(NegativeBatchingWorker, test_invalidBatchSize) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    ASSERT_THROW((BatchingWorker<int>{tp, t, [](auto) {}, 0,
+                                      std::chrono::seconds{1}}),
+                 std::invalid_argument);
+}
+
+TEST(NegativeBatchingWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    BatchingWorker<int> bw{tp, t, [](auto) {}, 4, std::chrono::seconds{1}};
+    bw.stop();
+
+    ASSERT_THROW(bw.add(1), std::runtime_error);
+}
+
+TEST(NegativeBatchingWorker, test_dropped) // NOLINT
+{
+    Threadpool tp{1};
+    ManualClock clock;
+    Timer t{clock};
+    auto hit = false;
+    BatchingWorker<int> bw{tp, t, [&hit](auto) { hit = true; }, 10,
+                           std::chrono::milliseconds{100}};
+    tp.stop();
+
+    // flushed by its delay
+    bw.add(1);
+    bw.add(2);
+    clock.advance(std::chrono::milliseconds{100});
+    ASSERT_EQ(2, bw.dropped());
+
+    // flushed by stop
+    bw.add(3);
+    bw.stop();
+    ASSERT_EQ(3, bw.dropped());
+    ASSERT_EQ(false, hit);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include <bureaucracy/cancellationtoken.hpp>
+
+using bureaucracy::CancellationSource;
+using bureaucracy::CancellationToken;
+
+TEST(CancellationToken, test_default) // NOLINT
+{
+    CancellationToken token;
+
+    ASSERT_EQ(false, token.isCancelled());
+}
+
+TEST(CancellationToken, test_cancel) // NOLINT
+{
+    CancellationSource source;
+    auto token = source.token();
+    auto copy = token;
+
+    ASSERT_EQ(false, source.isCancelled());
+    ASSERT_EQ(false, token.isCancelled());
+
+    source.cancel();
+    ASSERT_EQ(true, source.isCancelled());
+    ASSERT_EQ(true, token.isCancelled());
+    ASSERT_EQ(true, copy.isCancelled());
+    ASSERT_EQ(true, source.token().isCancelled());
+}
+
+TEST(CancellationToken, test_outlivesSource) // NOLINT
+{
+    CancellationToken token;
+    {
+        CancellationSource source;
+        token = source.token();
+        source.cancel();
+    }
+    ASSERT_EQ(true, token.isCancelled());
+}
+
+TEST(CancellationToken, test_withCancellation) // NOLINT
+{
+    CancellationSource source;
+    auto val = 0;
+    auto work = bureaucracy::withCancellation([&val]() { ++val; },
+                                              source.token());
+
+    work();
+    ASSERT_EQ(1, val);
+
+    source.cancel();
+    work();
+    ASSERT_EQ(1, val);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <bureaucracy/channel.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::Channel;
+using bureaucracy::Threadpool;
+
+TEST(Channel, test_ctor) // NOLINT
+{
+    Channel<int> c{5};
+
+    ASSERT_EQ(8, c.capacity());
+    ASSERT_EQ(0, c.size());
+    ASSERT_EQ(false, c.isClosed());
+}
+
+TEST(Channel, test_tryPushPop) // NOLINT
+{
+    Channel<int> c{4};
+
+    for(auto i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(true, c.tryPush(i));
+    }
+    ASSERT_EQ(false, c.tryPush(4));
+    ASSERT_EQ(4, c.size());
+
+    auto value = -1;
+    for(auto i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(true, c.tryPop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_EQ(false, c.tryPop(value));
+}
+
+TEST(Channel, test_moveOnly) // NOLINT
+{
+    Channel<std::unique_ptr<int>> c{2};
+
+    auto value = std::make_unique<int>(10);
+    ASSERT_EQ(true, c.tryPush(std::move(value)));
+    ASSERT_EQ(nullptr, value);
+
+    // a failed push leaves the value alone
+    ASSERT_EQ(true, c.tryPush(std::make_unique<int>(20)));
+    value = std::make_unique<int>(30);
+    ASSERT_EQ(false, c.tryPush(std::move(value)));
+    ASSERT_NE(nullptr, value);
+
+    std::unique_ptr<int> popped;
+    ASSERT_EQ(true, c.tryPop(popped));
+    ASSERT_EQ(10, *popped);
+}
+
+TEST(Channel, test_timed) // NOLINT
+{
+    Channel<int> c{2};
+
+    auto value = 0;
+    ASSERT_EQ(false, c.tryPopFor(value, std::chrono::milliseconds{10}));
+    c.push(1);
+    c.push(2);
+    ASSERT_EQ(false, c.tryPushFor(3, std::chrono::milliseconds{10}));
+    ASSERT_EQ(true, c.tryPopFor(value, std::chrono::milliseconds{10}));
+    ASSERT_EQ(1, value);
+}
+
+TEST(Channel, test_close) // NOLINT
+{
+    Channel<int> c{4};
+    c.push(1);
+
+    std::promise<bool> result;
+    std::thread consumer{[&c, &result]() {
+        auto value = 0;
+        c.pop(value);
+        result.set_value(c.pop(value));
+    }};
+    c.close();
+    consumer.join();
+
+    ASSERT_EQ(true, c.isClosed());
+    ASSERT_EQ(false, result.get_future().get());
+    ASSERT_EQ(false, c.tryPush(2));
+    ASSERT_THROW(c.push(2), std::runtime_error);
+}
+
+TEST(Channel, test_mpmc) // NOLINT
+{
+    Channel<int> c{8};
+    constexpr auto producers = 4;
+    constexpr auto perProducer = 10000;
+
+    std::atomic<long> total{0};
+    std::vector<std::thread> threads;
+    for(auto i = 0; i < producers; ++i)
+    {
+        threads.emplace_back([&c]() {
+            for(auto j = 1; j <= perProducer; ++j)
+            {
+                c.push(j);
+            }
+        });
+        threads.emplace_back([&c, &total]() {
+            auto value = 0;
+            while(c.pop(value))
+            {
+                total += value;
+            }
+        });
+    }
+    for(auto i = 0; i < producers; ++i)
+    {
+        threads[i * 2].join();
+    }
+    c.close();
+    for(auto i = 0; i < producers; ++i)
+    {
+        threads[(i * 2) + 1].join();
+    }
+
+    constexpr auto expected =
+        static_cast<long>(producers) * perProducer * (perProducer + 1) / 2;
+    ASSERT_EQ(expected, total);
+}
+
+TEST(Channel, test_consume) // NOLINT
+{
+    Threadpool tp{4};
+    Channel<int> c{4};
+
+    // values pushed before the consumer is attached are handled too
+    c.push(0);
+
+    std::vector<int> handled;
+    std::promise<void> done;
+    c.consume(tp, [&handled, &done](int value) {
+        handled.push_back(value);
+        if(value == 99)
+        {
+            done.set_value();
+        }
+    });
+    for(auto i = 1; i < 100; ++i)
+    {
+        c.push(i);
+    }
+    done.get_future().get();
+    c.stopConsuming();
+
+    std::vector<int> expected(100);
+    std::iota(std::begin(expected), std::end(expected), 0);
+    ASSERT_EQ(expected, handled);
+}
+
+TEST(NegativeChannel, test_twoConsumers) // NOLINT
+{
+    Threadpool tp{4};
+    Channel<int> c{4};
+    c.consume(tp, [](int) {});
+
+    ASSERT_THROW(c.consume(tp, [](int) {}), std::runtime_error);
+}
+
+TEST(NegativeChannel, test_consumerThrows) // NOLINT
+{
+    Threadpool tp{4};
+    Channel<int> c{4};
+
+    std::vector<int> handled;
+    std::promise<void> done;
+    c.consume(tp, [&handled, &done](int value) {
+        if(value % 2 == 0)
+        {
+            throw std::runtime_error{"bad value"};
+        }
+        handled.push_back(value);
+        if(value == 9)
+        {
+            done.set_value();
+        }
+    });
+    for(auto i = 0; i < 10; ++i)
+    {
+        c.push(i);
+    }
+    done.get_future().get();
+    c.stopConsuming();
+
+    ASSERT_EQ((std::vector<int>{1, 3, 5, 7, 9}), handled);
+}
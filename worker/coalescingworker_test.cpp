@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <string>
+#include <vector>
+
+#include <bureaucracy/coalescingworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::CoalescingWorker;
+using bureaucracy::Threadpool;
+
+TEST(CoalescingWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<int> cw{tp};
+
+    ASSERT_EQ(true, cw.isAccepting());
+    ASSERT_EQ(true, cw.isRunning());
+    ASSERT_EQ(0, cw.pendingKeys());
+    ASSERT_EQ(0, cw.coalesced());
+}
+
+TEST(CoalescingWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<int> cw{tp};
+
+    cw.stop();
+    ASSERT_EQ(false, cw.isAccepting());
+    ASSERT_EQ(false, cw.isRunning());
+}
+
+TEST(CoalescingWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<std::string> cw{tp};
+
+    std::promise<void> hit;
+    cw.add("key", [&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(CoalescingWorker, test_coalesce) // NOLINT
+{
+    Threadpool tp{1};
+    CoalescingWorker<int> cw{tp};
+
+    // Hold the only thread so everything below stays pending.
+    std::promise<void> release;
+    std::promise<void> blocked;
+    auto released = release.get_future().share();
+    tp.add([released, &blocked]() {
+        blocked.set_value();
+        released.get();
+    });
+    blocked.get_future().get();
+
+    std::vector<int> executed;
+    for(auto i = 0; i < 1000; ++i)
+    {
+        cw.add(i % 2, [&executed, i]() { executed.push_back(i); });
+    }
+    ASSERT_EQ(2, cw.pendingKeys());
+    ASSERT_EQ(998, cw.coalesced());
+
+    release.set_value();
+    cw.stop();
+
+    // the newest Work for each key is the one that runs
+    ASSERT_EQ((std::vector<int>{998, 999}), executed);
+}
+
+TEST(CoalescingWorker, test_addWhileRunning) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<int> cw{tp};
+
+    std::promise<void> release;
+    std::promise<void> started;
+    auto released = release.get_future().share();
+    cw.add(0, [released, &started]() {
+        started.set_value();
+        released.get();
+    });
+    started.get_future().get();
+
+    // the first round has started, so this gets a round of its own
+    std::promise<void> hit;
+    cw.add(0, [&hit]() { hit.set_value(); });
+    ASSERT_EQ(0, cw.coalesced());
+    release.set_value();
+    hit.get_future().get();
+}
+
+TEST(CoalescingWorker, test_stopWaitsUnkeyed) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<int> cw{tp};
+
+    std::promise<void> release;
+    auto done = false;
+    cw.add([&release, &done]() {
+        release.get_future().get();
+        done = true;
+    });
+
+    auto stopped = std::async(std::launch::async, [&cw]() { cw.stop(); });
+    ASSERT_EQ(std::future_status::timeout,
+              stopped.wait_for(std::chrono::milliseconds(100)));
+    release.set_value();
+    stopped.get();
+    ASSERT_EQ(true, done);
+}
+
+TEST(NegativeCoalescingWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    CoalescingWorker<int> cw{tp};
+    cw.stop();
+
+    ASSERT_THROW(cw.add(0, []() {}), std::runtime_error);
+    ASSERT_THROW(cw.add([]() {}), std::runtime_error);
+}
@@ -0,0 +1,71 @@
+#include <bureaucracy/deadlineworker.hpp>
+
+using bureaucracy::DeadlineWorker;
+
+DeadlineWorker::DeadlineWorker(Worker & worker)
+  : my_worker{worker, []() {}}
+  , my_dropped{0}
+{
+}
+
+/// \cond false
+DeadlineWorker::~DeadlineWorker() noexcept
+{
+    DeadlineWorker::stop();
+}
+/// \endcond
+
+void DeadlineWorker::add(Work work)
+{
+    my_worker.add(std::move(work));
+}
+
+void DeadlineWorker::add(Work work, Deadline deadline)
+{
+    my_worker.add([w = std::move(work), deadline, this]() {
+        if(Clock::now() <= deadline)
+        {
+            w();
+        }
+        else
+        {
+            ++my_dropped;
+        }
+    });
+}
+
+void DeadlineWorker::add(Work work, Deadline deadline, Work onExpired)
+{
+    my_worker.add([w = std::move(work), deadline, e = std::move(onExpired),
+                   this]() {
+        if(Clock::now() <= deadline)
+        {
+            w();
+        }
+        else
+        {
+            ++my_dropped;
+            e();
+        }
+    });
+}
+
+std::uint64_t DeadlineWorker::dropped() const noexcept
+{
+    return my_dropped;
+}
+
+void DeadlineWorker::stop()
+{
+    my_worker.stop();
+}
+
+bool DeadlineWorker::isAccepting() const noexcept
+{
+    return my_worker.isAccepting();
+}
+
+bool DeadlineWorker::isRunning() const noexcept
+{
+    return my_worker.isRunning();
+}
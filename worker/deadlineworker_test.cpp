@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <bureaucracy/deadlineworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::DeadlineWorker;
+using bureaucracy::Threadpool;
+
+TEST(DeadlineWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    DeadlineWorker dw{tp};
+
+    ASSERT_EQ(true, dw.isAccepting());
+    ASSERT_EQ(true, dw.isRunning());
+    ASSERT_EQ(0u, dw.dropped());
+}
+
+TEST(DeadlineWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    DeadlineWorker dw{tp};
+
+    dw.stop();
+    ASSERT_EQ(false, dw.isAccepting());
+    ASSERT_EQ(false, dw.isRunning());
+}
+
+TEST(DeadlineWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    DeadlineWorker dw{tp};
+
+    std::promise<void> hit;
+    dw.add([&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(DeadlineWorker, test_beforeDeadline) // NOLINT
+{
+    Threadpool tp{4};
+    DeadlineWorker dw{tp};
+
+    std::promise<void> hit;
+    dw.add([&hit]() { hit.set_value(); }, DeadlineWorker::Deadline::max());
+    hit.get_future().get();
+    dw.stop();
+    ASSERT_EQ(0u, dw.dropped());
+}
+
+TEST(DeadlineWorker, test_expired) // NOLINT
+{
+    Threadpool tp{1};
+    DeadlineWorker dw{tp};
+
+    // Hold the only thread so the deadlines pass while the Work is queued.
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    tp.add([released]() { released.get(); });
+
+    std::vector<int> executed;
+    auto const deadline =
+        DeadlineWorker::Clock::now() + std::chrono::milliseconds{10};
+    dw.add([&executed]() { executed.push_back(1); }, deadline);
+    dw.add([&executed]() { executed.push_back(2); });
+    dw.add([&executed]() { executed.push_back(3); }, deadline,
+           [&executed]() { executed.push_back(-3); });
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    release.set_value();
+    dw.stop();
+
+    ASSERT_EQ((std::vector<int>{2, -3}), executed);
+    ASSERT_EQ(2u, dw.dropped());
+}
+
+TEST(NegativeDeadlineWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    DeadlineWorker dw{tp};
+    dw.stop();
+
+    ASSERT_THROW(dw.add([]() {}), std::runtime_error);
+    ASSERT_THROW(dw.add([]() {}, DeadlineWorker::Deadline::max()),
+                 std::runtime_error);
+}
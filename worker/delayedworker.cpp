@@ -0,0 +1,233 @@
+#include <bureaucracy/delayedworker.hpp>
+
+#include <limits>
+#include <vector>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::DelayedWorker;
+
+DelayedWorker::DelayedWorker(Worker & worker, Timer & timer)
+  : my_worker{&worker}
+  , my_timer{&timer}
+  , my_alarmItem{nullptr, 0}
+  , my_alarmDue{Time::max()}
+  , my_alarm{0}
+  , my_armedAlarms{0}
+  , my_outstanding{0}
+  , my_dropped{0}
+  , my_nextId{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+}
+
+/// \cond false
+DelayedWorker::~DelayedWorker() noexcept
+{
+    DelayedWorker::stop();
+}
+/// \endcond
+
+void DelayedWorker::add(Work work)
+{
+    houseguest::synchronize(my_mutex, [this]() {
+        if(my_isAccepting)
+        {
+            ++my_outstanding;
+        }
+        else
+        {
+            throw std::runtime_error{"Not accepting work"};
+        }
+    });
+    try
+    {
+        my_worker->add([w = std::move(work), this]() {
+            w();
+            finished();
+        });
+    }
+    catch(...)
+    {
+        finished();
+        throw;
+    }
+}
+
+DelayedWorker::Item DelayedWorker::addAt(Work work, Time due)
+{
+    if(!(my_timer->now() < due))
+    {
+        add(std::move(work));
+        return Item{due, std::numeric_limits<Item::Id>::max()};
+    }
+
+    return houseguest::synchronize(my_mutex, [this, &work, due]() {
+        if(my_isAccepting)
+        {
+            if(due < my_alarmDue)
+            {
+                arm(due);
+            }
+            auto const id = my_nextId++;
+            my_delayed.emplace(Key{due, id}, std::move(work));
+            return Item{due, id};
+        }
+        throw std::runtime_error{"Not accepting work"};
+    });
+}
+
+bureaucracy::Timer::Item::CancelStatus DelayedWorker::cancel(Item item)
+{
+    return houseguest::synchronize(my_mutex, [this, &item]() {
+        // The alarm is left alone; if it fires early it'll find nothing due
+        // and re-arm for the next piece of Work.
+        if(my_delayed.erase(Key{item.my_due, item.my_id}) != 0)
+        {
+            return Timer::Item::CancelStatus::cancelled;
+        }
+        return Timer::Item::CancelStatus::failed;
+    });
+}
+
+void DelayedWorker::stop()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        if(my_isAccepting)
+        {
+            my_isAccepting = false;
+            my_delayed.clear();
+            if(my_alarmDue != Time::max())
+            {
+                if(my_timer->cancel(my_alarmItem) ==
+                   Timer::Item::CancelStatus::cancelled)
+                {
+                    --my_armedAlarms;
+                }
+                my_alarmDue = Time::max();
+            }
+            // Alarms that couldn't be cancelled are firing and hold a
+            // pointer to this DelayedWorker, so they have to finish too.
+            my_idle.wait(lock, [this]() {
+                return (my_outstanding == 0) && (my_armedAlarms == 0);
+            });
+            my_isRunning = false;
+        }
+    });
+}
+
+std::size_t DelayedWorker::dropped() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_dropped; });
+}
+
+bool DelayedWorker::isAccepting() const noexcept
+{
+    return houseguest::synchronize(my_mutex,
+                                   [this]() { return my_isAccepting; });
+}
+
+bool DelayedWorker::isRunning() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
+}
+
+void DelayedWorker::arm(Time due)
+{
+    // should be locked
+    auto const alarm = my_alarm + 1;
+    auto item = my_timer->add([this, alarm]() { fire(alarm); }, due);
+    if(my_alarmDue != Time::max())
+    {
+        if(my_timer->cancel(my_alarmItem) ==
+           Timer::Item::CancelStatus::cancelled)
+        {
+            --my_armedAlarms;
+        }
+    }
+    my_alarmItem = item;
+    my_alarmDue = due;
+    my_alarm = alarm;
+    ++my_armedAlarms;
+}
+
+void DelayedWorker::fire(std::uint64_t alarm)
+{
+    auto batch = houseguest::synchronize(my_mutex, [this, alarm]() {
+        std::vector<Work> ret;
+        if(alarm == my_alarm)
+        {
+            my_alarmDue = Time::max();
+        }
+        if(my_isAccepting)
+        {
+            auto const now = my_timer->now();
+            auto it = std::begin(my_delayed);
+            auto const end = std::end(my_delayed);
+            while((it != end) && !(now < it->first.first))
+            {
+                ret.emplace_back(std::move(it->second));
+                it = my_delayed.erase(it);
+            }
+            if(!my_delayed.empty())
+            {
+                auto const next = std::begin(my_delayed)->first.first;
+                if(next < my_alarmDue)
+                {
+                    try
+                    {
+                        arm(next);
+                    }
+                    catch(std::runtime_error const &)
+                    {
+                        // the Timer stopped, so nothing else can come due
+                    }
+                }
+            }
+            my_outstanding += ret.size();
+        }
+        return ret;
+    });
+
+    // Work that came due together isn't bundled, so a parallel Worker can
+    // spread it across its threads.
+    for(auto & work : batch)
+    {
+        try
+        {
+            my_worker->add([w = std::move(work), this]() {
+                w();
+                finished();
+            });
+        }
+        catch(std::runtime_error const &)
+        {
+            // the underlying Worker stopped; there's nowhere to send the Work
+            houseguest::synchronize(my_mutex, [this]() {
+                ++my_dropped;
+                --my_outstanding;
+                my_idle.notify_all();
+            });
+        }
+    }
+
+    houseguest::synchronize(my_mutex, [this]() {
+        --my_armedAlarms;
+        my_idle.notify_all();
+    });
+}
+
+void DelayedWorker::finished() noexcept
+{
+    houseguest::synchronize(my_mutex, [this]() {
+        --my_outstanding;
+        my_idle.notify_all();
+    });
+}
+
+DelayedWorker::Item::Item(Time due, Id id)
+  : my_due{due}
+  , my_id{id}
+{
+}
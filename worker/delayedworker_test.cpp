@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+
+#include <future>
+
+#include <bureaucracy/delayedworker.hpp>
+#include <bureaucracy/manualclock.hpp>
+#include <bureaucracy/serialworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::DelayedWorker;
+using bureaucracy::ManualClock;
+using bureaucracy::SerialWorker;
+using bureaucracy::Threadpool;
+using bureaucracy::Timer;
+
+TEST(DelayedWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    ASSERT_EQ(true, dw.isAccepting());
+    ASSERT_EQ(true, dw.isRunning());
+}
+
+TEST(DelayedWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    dw.stop();
+    ASSERT_EQ(false, dw.isAccepting());
+    ASSERT_EQ(false, dw.isRunning());
+}
+
+TEST(DelayedWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    std::promise<void> hit;
+    dw.add([&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(DelayedWorker, test_addAfter) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    std::promise<void> hit;
+    dw.addAfter([&hit]() { hit.set_value(); }, std::chrono::milliseconds(100));
+    hit.get_future().get();
+}
+
+TEST(DelayedWorker, test_addAt) // NOLINT
+{
+    Threadpool tp{4};
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{tp, t};
+
+    auto hit = false;
+    dw.addAt([&hit]() { hit = true; },
+             clock.now() + std::chrono::milliseconds(50));
+    clock.advance(std::chrono::milliseconds(49));
+    ASSERT_EQ(false, hit);
+
+    clock.advance(std::chrono::milliseconds(1));
+    dw.stop();
+    ASSERT_EQ(true, hit);
+}
+
+TEST(DelayedWorker, test_batchOrder) // NOLINT
+{
+    Threadpool tp{4};
+    SerialWorker sw{tp};
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{sw, t};
+
+    std::vector<int> order;
+    dw.addAfter([&order]() { order.push_back(2); }, std::chrono::seconds(3));
+    dw.addAfter([&order]() { order.push_back(0); }, std::chrono::seconds(1));
+    dw.addAfter([&order]() { order.push_back(1); }, std::chrono::seconds(1));
+    dw.addAfter([&order]() { order.push_back(3); }, std::chrono::seconds(5));
+
+    clock.advance(std::chrono::seconds(4));
+    dw.stop();
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), order);
+}
+
+TEST(DelayedWorker, test_dueTogether) // NOLINT
+{
+    Threadpool tp{2};
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{tp, t};
+
+    // each piece of Work waits for the other, so they have to run at once
+    std::promise<void> first;
+    std::promise<void> second;
+    auto firstDone = first.get_future().share();
+    auto secondDone = second.get_future().share();
+    std::promise<bool> together;
+    dw.addAfter(
+        [&first, secondDone]() {
+            first.set_value();
+            secondDone.wait();
+        },
+        std::chrono::seconds(1));
+    dw.addAfter(
+        [&second, firstDone, &together]() {
+            second.set_value();
+            together.set_value(firstDone.wait_for(std::chrono::seconds(5)) ==
+                               std::future_status::ready);
+        },
+        std::chrono::seconds(1));
+
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_EQ(true, together.get_future().get());
+    dw.stop();
+}
+
+TEST(DelayedWorker, test_cancel) // NOLINT
+{
+    Threadpool tp{4};
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{tp, t};
+
+    auto hit = false;
+    auto item = dw.addAfter([&hit]() { hit = true; }, std::chrono::seconds(1));
+    ASSERT_EQ(Timer::Item::CancelStatus::cancelled, dw.cancel(item));
+    ASSERT_EQ(Timer::Item::CancelStatus::failed, dw.cancel(item));
+
+    clock.advance(std::chrono::seconds(1));
+    dw.stop();
+    ASSERT_EQ(false, hit);
+}
+
+TEST(DelayedWorker, test_cancelFailed) // NOLINT
+{
+    Threadpool tp{4};
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{tp, t};
+
+    auto item = dw.addAfter([]() {}, std::chrono::seconds(1));
+    clock.advance(std::chrono::seconds(1));
+    ASSERT_EQ(Timer::Item::CancelStatus::failed, dw.cancel(item));
+}
+
+TEST(DelayedWorker, test_stopDiscards) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    auto hit = false;
+    dw.addAfter([&hit]() { hit = true; }, std::chrono::hours(1));
+    dw.stop();
+    ASSERT_EQ(false, hit);
+}
+
+TEST(NegativeDelayedWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    DelayedWorker dw{tp, t};
+
+    dw.stop();
+    ASSERT_THROW(dw.add([]() {}), std::runtime_error);
+    ASSERT_THROW(dw.addAfter([]() {}, std::chrono::seconds(1)),
+                 std::runtime_error);
+}
+
+TEST(NegativeDelayedWorker, test_dropped) // NOLINT
+{
+    Threadpool tp{4};
+    tp.stop();
+    ManualClock clock;
+    Timer t{clock};
+    DelayedWorker dw{tp, t};
+
+    dw.addAfter([]() {}, std::chrono::seconds(1));
+    dw.addAfter([]() {}, std::chrono::seconds(1));
+    clock.advance(std::chrono::seconds(1));
+
+    ASSERT_EQ(2u, dw.dropped());
+    dw.stop();
+}
@@ -1,10 +1,16 @@
 #include <bureaucracy/diligentworker.hpp>
 
+#include <houseguest/synchronize.hpp>
+
 using bureaucracy::DiligentWorker;
 
 DiligentWorker::DiligentWorker(Worker & worker, Alert alert)
-  : my_worker{worker}
+  : my_worker{&worker}
   , my_alert{std::move(alert)}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+  , my_busyPeriods{0}
 {
 }
 
@@ -17,27 +23,76 @@ DiligentWorker::~DiligentWorker() noexcept
 
 void DiligentWorker::add(Work work)
 {
-    my_worker.addDirect([w = std::move(work), this]() {
-        w();
-        if(!my_worker.isWorkQueued())
-        {
-            my_alert();
-            my_worker.notifyIfEmpty();
-        }
+    // Count the Work before checking my_isAccepting; stop does the opposite,
+    // so one of us always sees the other.
+    if(my_outstanding++ == 0)
+    {
+        houseguest::synchronize(my_mutex, [this]() { ++my_busyPeriods; });
+    }
+    if(!my_isAccepting)
+    {
+        finished(false);
+        throw std::runtime_error{"Not accepting work"};
+    }
+    try
+    {
+        my_worker->add([w = std::move(work), this]() {
+            w();
+            finished(true);
+        });
+    }
+    catch(...)
+    {
+        finished(false);
+        throw;
+    }
+}
+
+void DiligentWorker::waitIdle()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        my_isIdle.wait(lock, [this]() { return isIdle(); });
     });
 }
 
 void DiligentWorker::stop()
 {
-    my_worker.stop();
+    if(my_isAccepting.exchange(false))
+    {
+        waitIdle();
+        my_isRunning = false;
+    }
 }
 
 bool DiligentWorker::isAccepting() const noexcept
 {
-    return my_worker.isAccepting();
+    return my_isAccepting;
 }
 
 bool DiligentWorker::isRunning() const noexcept
 {
-    return my_worker.isRunning();
+    return my_isRunning;
+}
+
+void DiligentWorker::finished(bool alert) noexcept
+{
+    // Only the thread that takes the count to 0 sees 1 here, so each idle
+    // transition alerts exactly once.
+    if(my_outstanding-- == 1)
+    {
+        if(alert)
+        {
+            my_alert();
+        }
+        houseguest::synchronize(my_mutex, [this]() {
+            --my_busyPeriods;
+            my_isIdle.notify_all();
+        });
+    }
+}
+
+bool DiligentWorker::isIdle() const noexcept
+{
+    // should be locked
+    return (my_outstanding == 0) && (my_busyPeriods == 0);
 }
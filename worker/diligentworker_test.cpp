@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <future>
+#include <thread>
 
 #include <bureaucracy/diligentworker.hpp>
 #include <bureaucracy/threadpool.hpp>
@@ -59,6 +62,64 @@ TEST(DiligentWorker, test_alert) // NOLINT
     });
 }
 
+TEST(DiligentWorker, test_alertOnce) // NOLINT
+{
+    Threadpool tp{1};
+    std::atomic<int> alerts{0};
+    DiligentWorker dw{tp, [&alerts]() { ++alerts; }};
+
+    // Hold the only thread so all the Work is outstanding at once.
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    dw.add([released]() { released.get(); });
+
+    auto val = 0;
+    for(auto i = 0; i < 10; ++i)
+    {
+        dw.add([&val]() { ++val; });
+    }
+    release.set_value();
+    dw.waitIdle();
+
+    ASSERT_EQ(10, val);
+    ASSERT_EQ(1, alerts);
+
+    dw.add([&val]() { ++val; });
+    dw.waitIdle();
+
+    ASSERT_EQ(11, val);
+    ASSERT_EQ(2, alerts);
+}
+
+TEST(DiligentWorker, test_waitIdleFor) // NOLINT
+{
+    Threadpool tp{4};
+    DiligentWorker dw{tp, []() {}};
+
+    ASSERT_EQ(true, dw.waitIdleFor(std::chrono::milliseconds{0}));
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    dw.add([released]() { released.get(); });
+    ASSERT_EQ(false, dw.waitIdleFor(std::chrono::milliseconds{20}));
+
+    release.set_value();
+    ASSERT_EQ(true, dw.waitIdleFor(std::chrono::seconds{10}));
+}
+
+TEST(DiligentWorker, test_stopWaits) // NOLINT
+{
+    Threadpool tp{4};
+    auto alerted = false;
+    DiligentWorker dw{tp, [&alerted]() { alerted = true; }};
+
+    dw.add([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    });
+    dw.stop();
+    ASSERT_EQ(true, alerted);
+}
+
 TEST(NegativeDiligentWorker, test_addStopped) // NOLINT
 {
     Threadpool tp{4};
@@ -25,16 +25,21 @@ void ExpandingThreadpool::add(Work work)
 {
     my_threadpool.add(std::move(work));
     my_threadpool.addThreadIf(
-        [this](auto const & queuedWork, auto const & threads) {
+        [this](auto queuedWork, auto const & threads) {
             if(threads.size() < threads.capacity())
             {
-                auto const backlog = queuedWork.size() / threads.size();
+                auto const backlog = queuedWork / threads.size();
                 return backlog > my_maxBacklog;
             }
             return false;
         });
 }
 
+void ExpandingThreadpool::add(Work work, CancellationToken token)
+{
+    add(withCancellation(std::move(work), std::move(token)));
+}
+
 void ExpandingThreadpool::stop()
 {
     my_threadpool.stop();
@@ -4,6 +4,7 @@
 
 #include <bureaucracy/expandingthreadpool.hpp>
 
+using bureaucracy::CancellationSource;
 using bureaucracy::ExpandingThreadpool;
 
 TEST(ExpandingThreadpool, test_ctor) // NOLINT
@@ -83,6 +84,33 @@ TEST(ExpandingThreadpool, test_expandFail) // NOLINT
     tp.stop();
 }
 
+TEST(ExpandingThreadpool, test_cancel) // NOLINT
+{
+    ExpandingThreadpool tp{1, 4};
+
+    // Hold the only thread so everything below is queued.
+    std::promise<void> release;
+    std::promise<void> blocked;
+    auto released = release.get_future().share();
+    tp.add([released, &blocked]() {
+        blocked.set_value();
+        released.get();
+    });
+    blocked.get_future().get();
+
+    CancellationSource source;
+    auto cancelled = 0;
+    auto executed = 0;
+    tp.add([&cancelled]() { ++cancelled; }, source.token());
+    tp.add([&executed]() { ++executed; });
+    source.cancel();
+    release.set_value();
+    tp.stop();
+
+    ASSERT_EQ(0, cancelled);
+    ASSERT_EQ(1, executed);
+}
+
 TEST(NegativeExpandingThreadpool, test_invalidThreadCount) // NOLINT
 {
     try
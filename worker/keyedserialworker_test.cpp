@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+#include <bureaucracy/keyedserialworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::KeyedSerialWorker;
+using bureaucracy::Threadpool;
+
+TEST(KeyedSerialWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    ASSERT_EQ(true, ksw.isAccepting());
+    ASSERT_EQ(true, ksw.isRunning());
+    ASSERT_EQ(0, ksw.activeKeys());
+}
+
+TEST(KeyedSerialWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    ksw.stop();
+    ASSERT_EQ(false, ksw.isAccepting());
+    ASSERT_EQ(false, ksw.isRunning());
+}
+
+TEST(KeyedSerialWorker, test_workOrder) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp, 4};
+
+    constexpr auto keys = 8;
+    std::vector<int> vals(keys, 0);
+    for(auto i = 0; i < 1000; ++i)
+    {
+        for(auto key = 0; key < keys; ++key)
+        {
+            ksw.add(key, [&vals, key, i]() {
+                ASSERT_EQ(i, vals[key]);
+                ++vals[key];
+            });
+        }
+    }
+    ksw.stop();
+    for(auto const val : vals)
+    {
+        ASSERT_EQ(1000, val);
+    }
+}
+
+TEST(KeyedSerialWorker, test_keysRunInParallel) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<std::string> ksw{tp};
+
+    std::promise<void> blocked;
+    std::promise<void> hit;
+
+    ksw.add("first", [&blocked]() { blocked.get_future().get(); });
+    ksw.add("second", [&hit]() { hit.set_value(); });
+
+    // "second" doesn't have to wait for "first"
+    hit.get_future().get();
+    blocked.set_value();
+}
+
+TEST(KeyedSerialWorker, test_sequencing) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    std::promise<void> seqHit;
+    std::promise<void> normHit;
+
+    ksw.add(1, [&normHit]() { normHit.get_future().get(); });
+    ksw.add(1, [&seqHit]() { seqHit.set_value(); });
+
+    // sleep for a bit to give Work a chance to run
+    auto future = seqHit.get_future();
+    auto result = future.wait_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(std::future_status::timeout, result);
+
+    tp.add([&normHit]() { normHit.set_value(); });
+
+    future.get();
+}
+
+TEST(KeyedSerialWorker, test_reclaim) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::atomic<int> started{0};
+    for(auto key = 0; key < 3; ++key)
+    {
+        ksw.add(key, [released, &started]() {
+            ++started;
+            released.get();
+        });
+    }
+    ASSERT_EQ(3, ksw.activeKeys());
+
+    release.set_value();
+    ksw.stop();
+    ASSERT_EQ(0, ksw.activeKeys());
+    ASSERT_EQ(3, started);
+}
+
+TEST(KeyedSerialWorker, test_reuseKey) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    for(auto i = 0; i < 100; ++i)
+    {
+        std::promise<void> hit;
+        ksw.add(7, [&hit]() { hit.set_value(); });
+        hit.get_future().get();
+    }
+    ksw.stop();
+    ASSERT_EQ(0, ksw.activeKeys());
+}
+
+TEST(KeyedSerialWorker, test_stopWaitsUnkeyed) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    std::promise<void> release;
+    auto done = false;
+    ksw.add([&release, &done]() {
+        release.get_future().get();
+        done = true;
+    });
+    ASSERT_EQ(1, ksw.activeKeys());
+
+    auto stopped = std::async(std::launch::async, [&ksw]() { ksw.stop(); });
+    ASSERT_EQ(std::future_status::timeout,
+              stopped.wait_for(std::chrono::milliseconds(100)));
+    release.set_value();
+    stopped.get();
+    ASSERT_EQ(true, done);
+    ASSERT_EQ(0, ksw.activeKeys());
+}
+
+TEST(NegativeKeyedSerialWorker, test_zeroShards) // NOLINT
+{
+    Threadpool tp{4};
+
+    ASSERT_THROW(KeyedSerialWorker<int>(tp, 0), std::invalid_argument);
+}
+
+TEST(NegativeKeyedSerialWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    ksw.stop();
+    ASSERT_THROW(ksw.add(1, []() {}), std::runtime_error);
+    ASSERT_THROW(ksw.add([]() {}), std::runtime_error);
+    ASSERT_EQ(0, ksw.activeKeys());
+}
+
+TEST(NegativeKeyedSerialWorker, test_workerStopped) // NOLINT
+{
+    Threadpool tp{4};
+    KeyedSerialWorker<int> ksw{tp};
+
+    tp.stop();
+    ASSERT_THROW(ksw.add(1, []() {}), std::runtime_error);
+    ASSERT_EQ(0, ksw.activeKeys());
+}
@@ -0,0 +1,54 @@
+#include <bureaucracy/limitedworker.hpp>
+
+using bureaucracy::LimitedWorker;
+
+LimitedWorker::LimitedWorker(Worker & worker, std::size_t maxConcurrent)
+  : my_worker{worker}
+  , my_maxConcurrent{maxConcurrent}
+{
+    if(maxConcurrent == 0)
+    {
+        throw std::invalid_argument{"Invalid concurrency limit"};
+    }
+}
+
+/// \cond false
+LimitedWorker::~LimitedWorker() noexcept
+{
+    LimitedWorker::stop();
+}
+/// \endcond
+
+void LimitedWorker::add(Work work)
+{
+    my_worker.add([w = std::move(work), this](auto & workQueue) {
+        workQueue.emplace_back(std::move(w));
+        if(my_worker.startDrain(my_maxConcurrent))
+        {
+            my_worker.addDirect([this]() { drain(); });
+        }
+    });
+}
+
+void LimitedWorker::stop()
+{
+    my_worker.stop();
+}
+
+bool LimitedWorker::isAccepting() const noexcept
+{
+    return my_worker.isAccepting();
+}
+
+bool LimitedWorker::isRunning() const noexcept
+{
+    return my_worker.isRunning();
+}
+
+void LimitedWorker::drain() noexcept
+{
+    // Each drain is one slot; it keeps taking Work until the queue is empty.
+    while(my_worker.executeNext())
+    {
+    }
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
+#include <bureaucracy/limitedworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::LimitedWorker;
+using bureaucracy::Threadpool;
+
+TEST(LimitedWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    LimitedWorker lw{tp, 2};
+
+    ASSERT_EQ(true, lw.isAccepting());
+    ASSERT_EQ(true, lw.isRunning());
+}
+
+TEST(LimitedWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    LimitedWorker lw{tp, 2};
+
+    lw.stop();
+    ASSERT_EQ(false, lw.isAccepting());
+    ASSERT_EQ(false, lw.isRunning());
+}
+
+TEST(LimitedWorker, test_limit) // NOLINT
+{
+    Threadpool tp{8};
+    LimitedWorker lw{tp, 3};
+
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> completed{0};
+    for(auto i = 0; i < 50; ++i)
+    {
+        lw.add([&running, &peak, &completed]() {
+            auto const now = ++running;
+            auto seen = peak.load();
+            while((now > seen) && !peak.compare_exchange_weak(seen, now))
+            {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            --running;
+            ++completed;
+        });
+    }
+    lw.stop();
+    ASSERT_EQ(50, completed);
+    ASSERT_EQ(3, peak);
+}
+
+TEST(LimitedWorker, test_concurrent) // NOLINT
+{
+    Threadpool tp{4};
+    LimitedWorker lw{tp, 2};
+
+    // the second piece of Work can run while the first is blocked
+    std::promise<void> blocked;
+    std::promise<void> hit;
+    lw.add([&blocked]() { blocked.get_future().get(); });
+    lw.add([&hit]() { hit.set_value(); });
+
+    hit.get_future().get();
+    blocked.set_value();
+}
+
+TEST(LimitedWorker, test_sequencing) // NOLINT
+{
+    Threadpool tp{4};
+    LimitedWorker lw{tp, 1};
+
+    std::promise<void> seqHit;
+    std::promise<void> normHit;
+
+    lw.add([&normHit]() { normHit.get_future().get(); });
+    lw.add([&seqHit]() { seqHit.set_value(); });
+
+    // sleep for a bit to give Work a chance to run
+    auto future = seqHit.get_future();
+    auto result = future.wait_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(std::future_status::timeout, result);
+
+    tp.add([&normHit]() { normHit.set_value(); });
+
+    future.get();
+}
+
+TEST(NegativeLimitedWorker, test_zeroLimit) // NOLINT
+{
+    Threadpool tp{4};
+
+    ASSERT_THROW(LimitedWorker(tp, 0), std::invalid_argument);
+}
+
+TEST(NegativeLimitedWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    LimitedWorker lw{tp, 2};
+
+    lw.stop();
+    ASSERT_THROW(lw.add([]() {}), std::runtime_error);
+}
@@ -0,0 +1,184 @@
+#include <bureaucracy/lockfreeserialworker.hpp>
+
+#include <thread>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::LockFreeSerialWorker;
+
+LockFreeSerialWorker::LockFreeSerialWorker(Worker & worker)
+  : my_worker{&worker}
+  , my_head{&my_stub}
+  , my_tail{&my_stub}
+  , my_stub{{nullptr}, {}}
+  , my_queued{0}
+  , my_drains{0}
+  , my_isScheduled{false}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+}
+
+/// \cond false
+LockFreeSerialWorker::~LockFreeSerialWorker() noexcept
+{
+    LockFreeSerialWorker::stop();
+}
+/// \endcond
+
+void LockFreeSerialWorker::add(Work work)
+{
+    // Count the Work before checking whether we're accepting so stop can't
+    // miss it.
+    ++my_queued;
+    if(!my_isAccepting)
+    {
+        houseguest::synchronize(my_mutex, [this]() {
+            --my_queued;
+            my_isEmpty.notify_all();
+        });
+        throw std::runtime_error{"Not accepting work"};
+    }
+
+    // Count this add as a drain before publishing the Work.  A running drain
+    // can take the Work and finish before the flag below is checked, and
+    // this thread may still need to schedule a drain after that.
+    ++my_drains;
+    push(new Node{{nullptr}, std::move(work)});
+    if(!my_isScheduled.exchange(true))
+    {
+        // the count taken above now belongs to the scheduled drain
+        try
+        {
+            my_worker->add([this]() { drain(true); });
+        }
+        catch(...)
+        {
+            // Nothing will ever run what's queued, so this thread takes the
+            // drain's place and throws it all away.
+            drain(false);
+            throw;
+        }
+    }
+    else
+    {
+        releaseDrain();
+    }
+}
+
+void LockFreeSerialWorker::stop()
+{
+    if(my_isAccepting.exchange(false))
+    {
+        houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+            my_isEmpty.wait(lock, [this]() {
+                return (my_queued == 0) && (my_drains == 0);
+            });
+        });
+        my_isRunning = false;
+    }
+}
+
+bool LockFreeSerialWorker::isAccepting() const noexcept
+{
+    return my_isAccepting;
+}
+
+bool LockFreeSerialWorker::isRunning() const noexcept
+{
+    return my_isRunning;
+}
+
+void LockFreeSerialWorker::push(Node * node) noexcept
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    auto prev = my_head.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+LockFreeSerialWorker::Node * LockFreeSerialWorker::pop() noexcept
+{
+    // only called by the thread that's draining
+    auto tail = my_tail;
+    auto next = tail->next.load(std::memory_order_acquire);
+    if(tail == &my_stub)
+    {
+        if(next == nullptr)
+        {
+            return nullptr;
+        }
+        my_tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if(next != nullptr)
+    {
+        my_tail = next;
+        return tail;
+    }
+    if(tail != my_head.load(std::memory_order_acquire))
+    {
+        // a producer is part way through a push
+        return nullptr;
+    }
+    push(&my_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if(next != nullptr)
+    {
+        my_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+void LockFreeSerialWorker::drain(bool execute) noexcept
+{
+    while(true)
+    {
+        auto ran = false;
+        auto node = pop();
+        while(node != nullptr)
+        {
+            if(execute)
+            {
+                node->work();
+            }
+            delete node;
+            --my_queued;
+            ran = true;
+            node = pop();
+        }
+
+        // Give up the drain, then make sure nothing slipped in before the
+        // flag was cleared.  A producer that pushed after this point will
+        // schedule its own drain.
+        my_isScheduled = false;
+        if((my_queued == 0) || my_isScheduled.exchange(true))
+        {
+            break;
+        }
+        if(!ran)
+        {
+            // a producer hasn't finished linking its Work in yet
+            std::this_thread::yield();
+        }
+    }
+    releaseDrain();
+}
+
+void LockFreeSerialWorker::releaseDrain() noexcept
+{
+    // Only the decrement that could let stop return needs the lock.
+    auto drains = my_drains.load();
+    while(drains > 1)
+    {
+        if(my_drains.compare_exchange_weak(drains, drains - 1))
+        {
+            return;
+        }
+    }
+    houseguest::synchronize(my_mutex, [this]() {
+        --my_drains;
+        my_isEmpty.notify_all();
+    });
+}
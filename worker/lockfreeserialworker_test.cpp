@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <bureaucracy/lockfreeserialworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::LockFreeSerialWorker;
+using bureaucracy::Threadpool;
+using bureaucracy::Worker;
+
+namespace
+{
+    // Counts drains that are scheduled after the LockFreeSerialWorker
+    // feeding it has stopped.
+    class WatchingWorker : public Worker
+    {
+    public:
+        explicit WatchingWorker(Worker & worker)
+          : my_worker{&worker}
+        {
+        }
+
+        void add(Work work) override
+        {
+            if(stopped)
+            {
+                ++late;
+            }
+            my_worker->add(std::move(work));
+        }
+
+        void stop() override
+        {
+        }
+
+        bool isAccepting() const noexcept override
+        {
+            return true;
+        }
+
+        bool isRunning() const noexcept override
+        {
+            return true;
+        }
+
+        std::atomic<bool> stopped{false};
+        std::atomic<int> late{0};
+
+    private:
+        Worker * const my_worker;
+    };
+} // namespace
+
+TEST(LockFreeSerialWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    ASSERT_EQ(true, sw.isAccepting());
+    ASSERT_EQ(true, sw.isRunning());
+}
+
+TEST(LockFreeSerialWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    sw.stop();
+    ASSERT_EQ(false, sw.isAccepting());
+    ASSERT_EQ(false, sw.isRunning());
+}
+
+TEST(LockFreeSerialWorker, test_workOrder) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    auto val = 0;
+    for(auto i = 0; i < 1000; ++i)
+    {
+        sw.add([&val, i]() {
+            ASSERT_EQ(i, val);
+            ++val;
+        });
+    }
+    sw.stop();
+    ASSERT_EQ(1000, val);
+}
+
+TEST(LockFreeSerialWorker, test_sequencing) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    std::promise<void> seqHit;
+    std::promise<void> normHit;
+
+    sw.add([&normHit]() { normHit.get_future().get(); });
+    sw.add([&seqHit]() { seqHit.set_value(); });
+
+    // sleep for a bit to give Work a chance to run
+    auto future = seqHit.get_future();
+    auto result = future.wait_for(std::chrono::milliseconds(200));
+    ASSERT_EQ(std::future_status::timeout, result);
+
+    tp.add([&normHit]() { normHit.set_value(); });
+
+    future.get();
+}
+
+TEST(LockFreeSerialWorker, test_producers) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    // Work is never run concurrently, so a plain int is safe to use
+    auto constexpr perThread = 10000;
+    auto total = 0;
+    std::vector<int> lastSeen(4, -1);
+    std::vector<std::thread> producers;
+    for(auto p = 0u; p < lastSeen.size(); ++p)
+    {
+        producers.emplace_back([&sw, &total, &lastSeen, p]() {
+            for(auto i = 0; i < perThread; ++i)
+            {
+                sw.add([&total, &lastSeen, p, i]() {
+                    // each producer's Work arrives in the order it was added
+                    ASSERT_EQ(i - 1, lastSeen[p]);
+                    lastSeen[p] = i;
+                    ++total;
+                });
+            }
+        });
+    }
+    for(auto & producer : producers)
+    {
+        producer.join();
+    }
+    sw.stop();
+    ASSERT_EQ(perThread * 4, total);
+}
+
+TEST(LockFreeSerialWorker, test_destroyAfterWork) // NOLINT
+{
+    Threadpool tp{4};
+
+    // The worker goes away as soon as its last Work is done; the drain must
+    // not touch it afterwards.
+    for(auto i = 0; i < 1000; ++i)
+    {
+        std::promise<void> hit;
+        {
+            LockFreeSerialWorker sw{tp};
+            sw.add([&hit]() { hit.set_value(); });
+            hit.get_future().get();
+        }
+    }
+}
+
+TEST(LockFreeSerialWorker, test_stopWhileAdding) // NOLINT
+{
+    Threadpool tp{4};
+
+    // Once stop returns, nothing may schedule another drain.
+    for(auto i = 0; i < 20; ++i)
+    {
+        WatchingWorker ww{tp};
+        LockFreeSerialWorker sw{ww};
+        std::atomic<int> started{0};
+        std::vector<std::thread> producers;
+        for(auto p = 0; p < 4; ++p)
+        {
+            producers.emplace_back([&sw, &started]() {
+                ++started;
+                try
+                {
+                    while(true)
+                    {
+                        sw.add([]() {});
+                    }
+                }
+                catch(std::runtime_error const &)
+                {
+                    // stopped
+                }
+            });
+        }
+        while(started != 4)
+        {
+            std::this_thread::yield();
+        }
+        sw.stop();
+        ww.stopped = true;
+        for(auto & producer : producers)
+        {
+            producer.join();
+        }
+        ASSERT_EQ(0, ww.late);
+    }
+}
+
+TEST(NegativeLockFreeSerialWorker, test_workerStopped) // NOLINT
+{
+    Threadpool tp{4};
+    tp.stop();
+    LockFreeSerialWorker sw{tp};
+
+    auto tracker = std::make_shared<int>(0);
+    ASSERT_THROW(sw.add([tracker]() {}), std::runtime_error);
+
+    // the rejected Work was freed and doesn't hold up stop
+    ASSERT_EQ(1, tracker.use_count());
+    sw.stop();
+    ASSERT_EQ(false, sw.isRunning());
+}
+
+TEST(NegativeLockFreeSerialWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    LockFreeSerialWorker sw{tp};
+
+    sw.stop();
+    ASSERT_THROW(sw.add([]() {}), std::runtime_error);
+}
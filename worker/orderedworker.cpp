@@ -0,0 +1,124 @@
+#include <bureaucracy/orderedworker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::OrderedWorker;
+
+OrderedWorker::OrderedWorker(Worker & worker, std::size_t window)
+  : my_worker{&worker}
+  , my_slots(window)
+  , my_nextSequence{0}
+  , my_nextCompletion{0}
+  , my_isCompleting{false}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+    if(window == 0)
+    {
+        throw std::invalid_argument{"Invalid window size"};
+    }
+}
+
+/// \cond false
+OrderedWorker::~OrderedWorker() noexcept
+{
+    OrderedWorker::stop();
+}
+/// \endcond
+
+void OrderedWorker::add(Work work, Completion completion)
+{
+    auto const sequence = houseguest::synchronize_unique(
+        my_mutex, [this, &completion](auto lock) {
+            my_hasSpace.wait(lock, [this]() {
+                return !my_isAccepting ||
+                       (my_nextSequence - my_nextCompletion < my_slots.size());
+            });
+            if(!my_isAccepting)
+            {
+                throw std::runtime_error{"Not accepting work"};
+            }
+            auto const ret = my_nextSequence++;
+            slotFor(ret) = Slot{std::move(completion), false};
+            return ret;
+        });
+
+    try
+    {
+        my_worker->add([w = std::move(work), sequence, this]() {
+            w();
+            finished(sequence);
+        });
+    }
+    catch(...)
+    {
+        // keep the sequence moving so later Completions aren't stuck
+        houseguest::synchronize(my_mutex, [this, sequence]() {
+            slotFor(sequence).completion = Completion{};
+        });
+        finished(sequence);
+        throw;
+    }
+}
+
+void OrderedWorker::stop()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        if(my_isAccepting)
+        {
+            my_isAccepting = false;
+            my_hasSpace.notify_all();
+            my_isIdle.wait(lock, [this]() {
+                return (my_nextCompletion == my_nextSequence) &&
+                       !my_isCompleting;
+            });
+            my_isRunning = false;
+        }
+    });
+}
+
+bool OrderedWorker::isAccepting() const noexcept
+{
+    return houseguest::synchronize(my_mutex,
+                                   [this]() { return my_isAccepting; });
+}
+
+bool OrderedWorker::isRunning() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
+}
+
+void OrderedWorker::finished(std::uint64_t sequence) noexcept
+{
+    houseguest::synchronize_unique(my_mutex, [this, sequence](auto lock) {
+        slotFor(sequence).isDone = true;
+        if(my_isCompleting)
+        {
+            // whoever is completing will get to this one
+            return;
+        }
+        my_isCompleting = true;
+        while((my_nextCompletion != my_nextSequence) &&
+              slotFor(my_nextCompletion).isDone)
+        {
+            auto completion = std::move(slotFor(my_nextCompletion).completion);
+            if(completion)
+            {
+                lock.unlock();
+                completion();
+                lock.lock();
+            }
+            // the slot is only free once its Completion has returned
+            ++my_nextCompletion;
+            my_hasSpace.notify_one();
+        }
+        my_isCompleting = false;
+        my_isIdle.notify_all();
+    });
+}
+
+OrderedWorker::Slot & OrderedWorker::slotFor(std::uint64_t sequence) noexcept
+{
+    // should be locked
+    return my_slots[sequence % my_slots.size()];
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <bureaucracy/orderedworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::OrderedWorker;
+using bureaucracy::Threadpool;
+
+TEST(OrderedWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    OrderedWorker ow{tp, 4};
+
+    ASSERT_EQ(true, ow.isAccepting());
+    ASSERT_EQ(true, ow.isRunning());
+}
+
+TEST(OrderedWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    OrderedWorker ow{tp, 4};
+
+    ow.stop();
+    ASSERT_EQ(false, ow.isAccepting());
+    ASSERT_EQ(false, ow.isRunning());
+}
+
+TEST(OrderedWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    OrderedWorker ow{tp, 4};
+
+    std::promise<void> hit;
+    ow.add([&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(OrderedWorker, test_completionOrder) // NOLINT
+{
+    Threadpool tp{4};
+    OrderedWorker ow{tp, 8};
+
+    // Earlier Work takes longer, so it tends to finish last.
+    std::vector<int> completed;
+    for(auto i = 0; i < 40; ++i)
+    {
+        ow.add(
+            [i]() {
+                std::this_thread::sleep_for(
+                    std::chrono::milliseconds{(40 - i) % 8});
+            },
+            [&completed, i]() { completed.push_back(i); });
+    }
+    ow.stop();
+
+    ASSERT_EQ(40, completed.size());
+    for(auto i = 0; i < 40; ++i)
+    {
+        ASSERT_EQ(i, completed[i]);
+    }
+}
+
+TEST(OrderedWorker, test_window) // NOLINT
+{
+    Threadpool tp{4};
+    constexpr auto window = 3;
+    OrderedWorker ow{tp, window};
+
+    std::atomic<int> started{0};
+    std::atomic<int> completed{0};
+    std::atomic<int> violations{0};
+    for(auto i = 0; i < 200; ++i)
+    {
+        ow.add(
+            [&started, &completed, &violations]() {
+                if(++started - completed > window)
+                {
+                    ++violations;
+                }
+            },
+            [&completed]() { ++completed; });
+    }
+    ow.stop();
+
+    ASSERT_EQ(200, completed);
+    ASSERT_EQ(0, violations);
+}
+
+TEST(NegativeOrderedWorker, test_invalidWindow) // NOLINT
+{
+    Threadpool tp{4};
+    ASSERT_THROW((OrderedWorker{tp, 0}), std::invalid_argument);
+}
+
+TEST(NegativeOrderedWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    OrderedWorker ow{tp, 4};
+    ow.stop();
+
+    ASSERT_THROW(ow.add([]() {}, []() {}), std::runtime_error);
+}
@@ -0,0 +1,222 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bureaucracy/pipelinestage.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::PipelineStage;
+using bureaucracy::Threadpool;
+using bureaucracy::Worker;
+
+namespace
+{
+    // Waits in add until it's released, then rejects the Work.
+    class RejectingWorker : public Worker
+    {
+    public:
+        void add(Work /* work */) override
+        {
+            adding.set_value();
+            released.get_future().get();
+            throw std::runtime_error{"Not accepting work"};
+        }
+
+        void stop() override
+        {
+        }
+
+        bool isAccepting() const noexcept override
+        {
+            return false;
+        }
+
+        bool isRunning() const noexcept override
+        {
+            return true;
+        }
+
+        std::promise<void> adding;
+        std::promise<void> released;
+    };
+} // namespace
+
+TEST(PipelineStage, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    PipelineStage<int> ps{tp, [](int) {}, 1, 4};
+
+    ASSERT_EQ(true, ps.isAccepting());
+    ASSERT_EQ(true, ps.isRunning());
+    ASSERT_EQ(0, ps.processed());
+    ASSERT_EQ(0, ps.queued());
+    ASSERT_EQ(0, ps.stalls());
+}
+
+TEST(PipelineStage, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    PipelineStage<int> ps{tp, [](int) {}, 1, 4};
+
+    ps.stop();
+    ASSERT_EQ(false, ps.isAccepting());
+    ASSERT_EQ(false, ps.isRunning());
+}
+
+TEST(PipelineStage, test_push) // NOLINT
+{
+    Threadpool tp{4};
+    std::promise<int> hit;
+    PipelineStage<int> ps{tp, [&hit](int value) { hit.set_value(value); }, 1,
+                          4};
+
+    ps.push(10);
+    ASSERT_EQ(10, hit.get_future().get());
+}
+
+TEST(PipelineStage, test_chain) // NOLINT
+{
+    Threadpool tp{4};
+
+    // Serial stages keep values in order.
+    std::vector<std::string> output;
+    PipelineStage<std::string> last{
+        tp, [&output](std::string value) { output.push_back(value); }, 1, 4};
+    PipelineStage<int> first{
+        tp, [](int value) { return std::to_string(value * 2); }, last, 1, 4};
+    for(auto i = 0; i < 100; ++i)
+    {
+        first.push(i);
+    }
+    first.stop();
+    last.stop();
+
+    ASSERT_EQ(100, first.processed());
+    ASSERT_EQ(100, last.processed());
+    ASSERT_EQ(100, output.size());
+    for(auto i = 0; i < 100; ++i)
+    {
+        ASSERT_EQ(std::to_string(i * 2), output[i]);
+    }
+}
+
+TEST(PipelineStage, test_backpressure) // NOLINT
+{
+    Threadpool tp{4};
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::promise<void> blocked;
+    auto isBlocked = blocked.get_future().share();
+    PipelineStage<int> ps{tp,
+                          [released, &blocked](int value) {
+                              if(value == 0)
+                              {
+                                  blocked.set_value();
+                                  released.get();
+                              }
+                          },
+                          1, 2};
+
+    ps.push(0);
+    isBlocked.get();
+    ps.push(1);
+    ps.push(2);
+    ASSERT_EQ(2, ps.queued());
+    ASSERT_EQ(0, ps.stalls());
+
+    // the queue is full, so this push has to wait for the handler
+    std::thread producer{[&ps]() { ps.push(3); }};
+    while(ps.stalls() == 0)
+    {
+        std::this_thread::yield();
+    }
+    release.set_value();
+    producer.join();
+    ps.stop();
+
+    ASSERT_EQ(4, ps.processed());
+    ASSERT_EQ(1, ps.stalls());
+}
+
+TEST(NegativePipelineStage, test_invalidArguments) // NOLINT
+{
+    Threadpool tp{4};
+    ASSERT_THROW((PipelineStage<int>{tp, [](int) {}, 0, 4}),
+                 std::invalid_argument);
+    ASSERT_THROW((PipelineStage<int>{tp, [](int) {}, 1, 0}),
+                 std::invalid_argument);
+}
+
+TEST(NegativePipelineStage, test_pushStopped) // NOLINT
+{
+    Threadpool tp{4};
+    PipelineStage<int> ps{tp, [](int) {}, 1, 4};
+    ps.stop();
+
+    ASSERT_THROW(ps.push(1), std::runtime_error);
+}
+
+TEST(NegativePipelineStage, test_stopOutOfOrder) // NOLINT
+{
+    Threadpool tp{4};
+    PipelineStage<int> last{tp, [](int) {}, 1, 4};
+    PipelineStage<int> first{tp, [](int value) { return value; }, last, 2, 4};
+
+    // the next stage refuses the result, so it's dropped rather than lost
+    last.stop();
+    for(auto i = 0; i < 3; ++i)
+    {
+        first.push(i);
+    }
+    first.stop();
+
+    ASSERT_EQ(0, first.processed());
+    ASSERT_EQ(3, first.dropped());
+}
+
+TEST(NegativePipelineStage, test_drainRejected) // NOLINT
+{
+    RejectingWorker rw;
+    PipelineStage<int> ps{rw, [](int) {}, 1, 4};
+
+    // the first push is still handing off its drain while the rest queue up
+    // behind it, so they're dropped along with it
+    std::thread pusher{[&ps]() {
+        ASSERT_THROW(ps.push(0), std::runtime_error);
+    }};
+    rw.adding.get_future().get();
+    ps.push(1);
+    ps.push(2);
+    rw.released.set_value();
+    pusher.join();
+    ps.stop();
+
+    ASSERT_EQ(0, ps.processed());
+    ASSERT_EQ(3, ps.dropped());
+}
+
+TEST(NegativePipelineStage, test_handlerThrows) // NOLINT
+{
+    Threadpool tp{4};
+    PipelineStage<int> ps{tp,
+                          [](int value) {
+                              if(value % 2 == 0)
+                              {
+                                  throw std::runtime_error{"bad value"};
+                              }
+                          },
+                          1, 4};
+
+    for(auto i = 0; i < 4; ++i)
+    {
+        ps.push(i);
+    }
+    ps.stop();
+
+    ASSERT_EQ(2, ps.processed());
+    ASSERT_EQ(2, ps.dropped());
+}
@@ -1,13 +1,373 @@
 #include <bureaucracy/priorityworker.hpp>
 
 #include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <bureaucracy/indexedheap.hpp>
+
+#include <houseguest/synchronize.hpp>
 
 using bureaucracy::PriorityWorker;
 
+namespace
+{
+    using Rank = std::chrono::steady_clock::rep;
+
+    Rank rankOf(PriorityWorker::Priority priority,
+                PriorityWorker::AgingInterval agingInterval) noexcept
+    {
+        if(agingInterval == PriorityWorker::AgingInterval::zero())
+        {
+            return priority;
+        }
+        // Ranking by when the Work should be considered urgent lets the
+        // order be decided once, at add, while still letting old Work
+        // overtake newer Work of a better Priority.
+        auto const now = std::chrono::steady_clock::now().time_since_epoch();
+        auto const headroom = std::numeric_limits<Rank>::max() - now.count();
+        if(static_cast<Rank>(priority) > (headroom / agingInterval.count()))
+        {
+            // Saturate rather than wrap; Work this far off still runs in
+            // the order it was added.
+            return std::numeric_limits<Rank>::max();
+        }
+        return now.count() + (static_cast<Rank>(priority) *
+                              agingInterval.count());
+    }
+
+    void checkAgingInterval(PriorityWorker::AgingInterval agingInterval)
+    {
+        if(!(agingInterval > PriorityWorker::AgingInterval::zero()))
+        {
+            throw std::invalid_argument{"Invalid aging interval"};
+        }
+    }
+
+    struct IsEarlier
+    {
+        template <typename NODE>
+        bool operator()(NODE const & lhs, NODE const & rhs) const noexcept
+        {
+            // Sequence numbers keep Work with the same rank in FIFO order.
+            return (lhs.rank < rhs.rank) ||
+                   ((lhs.rank == rhs.rank) && (lhs.sequence < rhs.sequence));
+        }
+    };
+
+    using Heap = bureaucracy::IndexedHeap<2, IsEarlier>;
+} // namespace
+
+/// \cond false
+class PriorityWorker::Queue
+{
+public:
+    virtual bool accepts(Priority priority) const noexcept = 0;
+
+    virtual Handle::Id push(Priority priority, Work work) = 0;
+
+    virtual bool cancel(Handle::Id id) = 0;
+
+    virtual bool reprioritize(Handle::Id id, Priority priority) = 0;
+
+    // returns an empty Work if everything queued was cancelled
+    virtual Work pop() = 0;
+
+    // the number of pieces of Work that haven't been cancelled or popped
+    virtual std::size_t size() const noexcept = 0;
+
+    virtual ~Queue() noexcept = default;
+};
+
+class PriorityWorker::HeapQueue : public PriorityWorker::Queue
+{
+public:
+    explicit HeapQueue(AgingInterval agingInterval)
+      : my_agingInterval{agingInterval}
+      , my_nextSequence{0}
+    {
+    }
+
+    bool accepts(Priority /* priority */) const noexcept override
+    {
+        return true;
+    }
+
+    Handle::Id push(Priority priority, Work work) override
+    {
+        auto const sequence = my_nextSequence++;
+        auto inserted =
+            my_entries.emplace(sequence, Entry{std::move(work), sequence, 0});
+        auto & entry = inserted.first->second;
+        my_heap.emplace_back(
+            Node{rankOf(priority, my_agingInterval), sequence, &entry});
+        Heap::siftUp(my_heap, my_heap.size() - 1);
+        return sequence;
+    }
+
+    bool cancel(Handle::Id id) override
+    {
+        auto it = my_entries.find(id);
+        if(it == std::end(my_entries))
+        {
+            return false;
+        }
+        Heap::removeAt(my_heap, it->second.index);
+        my_entries.erase(it);
+        return true;
+    }
+
+    bool reprioritize(Handle::Id id, Priority priority) override
+    {
+        auto it = my_entries.find(id);
+        if(it == std::end(my_entries))
+        {
+            return false;
+        }
+        auto const index = it->second.index;
+        my_heap[index].rank = rankOf(priority, my_agingInterval);
+        my_heap[index].sequence = my_nextSequence++;
+        Heap::siftDown(my_heap, index);
+        Heap::siftUp(my_heap, it->second.index);
+        return true;
+    }
+
+    Work pop() override
+    {
+        if(my_heap.empty())
+        {
+            return Work{};
+        }
+        auto const entry = my_heap.front().entry;
+        auto ret = std::move(entry->work);
+        auto const id = entry->id;
+        Heap::removeAt(my_heap, 0);
+        my_entries.erase(id);
+        return ret;
+    }
+
+    std::size_t size() const noexcept override
+    {
+        return my_entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        Work work;
+        Handle::Id id;
+        std::size_t index;
+    };
+
+    struct Node
+    {
+        Rank rank;
+        std::uint64_t sequence;
+        Entry * entry;
+    };
+
+    AgingInterval const my_agingInterval;
+
+    // Entries live in a node-based container so the heap can point at them
+    // and keep their index current as nodes move.
+    std::unordered_map<Handle::Id, Entry> my_entries;
+    std::vector<Node> my_heap;
+    std::uint64_t my_nextSequence;
+};
+
+class PriorityWorker::BucketQueue : public PriorityWorker::Queue
+{
+public:
+    BucketQueue(Priority levels, AgingInterval agingInterval)
+      : my_agingInterval{agingInterval}
+      , my_buckets(levels)
+      , my_first{levels}
+      , my_nextSequence{0}
+    {
+    }
+
+    bool accepts(Priority priority) const noexcept override
+    {
+        return priority < my_buckets.size();
+    }
+
+    Handle::Id push(Priority priority, Work work) override
+    {
+        auto const sequence = my_nextSequence++;
+        my_entries.emplace(sequence, Entry{std::move(work), sequence});
+        enqueue(priority, sequence, sequence);
+        return sequence;
+    }
+
+    bool cancel(Handle::Id id) override
+    {
+        // The bucket still holds a node for this Work; it's skipped when it
+        // reaches the front.
+        return my_entries.erase(id) != 0;
+    }
+
+    bool reprioritize(Handle::Id id, Priority priority) override
+    {
+        auto it = my_entries.find(id);
+        if(it == std::end(my_entries))
+        {
+            return false;
+        }
+        // the old node no longer matches the Entry's sequence, so it's
+        // skipped just like a cancelled one
+        auto const sequence = my_nextSequence++;
+        it->second.sequence = sequence;
+        enqueue(priority, id, sequence);
+        return true;
+    }
+
+    Work pop() override
+    {
+        if(my_entries.empty())
+        {
+            return Work{};
+        }
+        // my_first never points past a bucket with live Work, so this only
+        // skips buckets that were emptied since the last pop
+        while(!prune(my_buckets[my_first]))
+        {
+            ++my_first;
+        }
+        auto best = my_first;
+        if(my_agingInterval != AgingInterval::zero())
+        {
+            // Each bucket is in rank order, so only the oldest Work in each
+            // can be next.
+            for(auto i = best + 1; i < my_buckets.size(); ++i)
+            {
+                auto & bucket = my_buckets[i];
+                if(prune(bucket) &&
+                   (bucket.front().rank < my_buckets[best].front().rank))
+                {
+                    best = i;
+                }
+            }
+        }
+        auto & bucket = my_buckets[best];
+        auto it = my_entries.find(bucket.front().id);
+        auto ret = std::move(it->second.work);
+        my_entries.erase(it);
+        bucket.pop_front();
+        return ret;
+    }
+
+    std::size_t size() const noexcept override
+    {
+        return my_entries.size();
+    }
+
+private:
+    struct Entry
+    {
+        Work work;
+        std::uint64_t sequence;
+    };
+
+    struct Node
+    {
+        Rank rank;
+        Handle::Id id;
+        std::uint64_t sequence;
+    };
+
+    using Bucket = std::deque<Node>;
+
+    void enqueue(Priority priority, Handle::Id id, std::uint64_t sequence)
+    {
+        my_buckets[priority].emplace_back(
+            Node{rankOf(priority, my_agingInterval), id, sequence});
+        my_first = std::min<std::size_t>(my_first, priority);
+    }
+
+    bool prune(Bucket & bucket)
+    {
+        // drop cancelled or moved Work from the front of bucket, returning
+        // true if any live Work remains
+        while(!bucket.empty())
+        {
+            auto it = my_entries.find(bucket.front().id);
+            if((it != std::end(my_entries)) &&
+               (it->second.sequence == bucket.front().sequence))
+            {
+                return true;
+            }
+            bucket.pop_front();
+        }
+        return false;
+    }
+
+    AgingInterval const my_agingInterval;
+    std::unordered_map<Handle::Id, Entry> my_entries;
+    std::vector<Bucket> my_buckets;
+    std::size_t my_first;
+    std::uint64_t my_nextSequence;
+};
+/// \endcond
+
 PriorityWorker::PriorityWorker(Worker & worker, Priority defaultPriority)
-  : my_worker{worker}
+  : my_worker{&worker}
+  , my_queue{std::make_unique<HeapQueue>(AgingInterval::zero())}
+  , my_defaultPriority{defaultPriority}
+  , my_scheduled{0}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+}
+
+PriorityWorker::PriorityWorker(Worker & worker, Priority defaultPriority,
+                               Priority levels)
+  : my_worker{&worker}
+  , my_queue{std::make_unique<BucketQueue>(levels, AgingInterval::zero())}
+  , my_defaultPriority{defaultPriority}
+  , my_scheduled{0}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+    if((levels == 0) || !(defaultPriority < levels))
+    {
+        throw std::invalid_argument{"Invalid priority levels"};
+    }
+}
+
+PriorityWorker::PriorityWorker(Worker & worker, Priority defaultPriority,
+                               AgingInterval agingInterval)
+  : my_worker{&worker}
+  , my_queue{std::make_unique<HeapQueue>(agingInterval)}
   , my_defaultPriority{defaultPriority}
+  , my_scheduled{0}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
 {
+    checkAgingInterval(agingInterval);
+}
+
+PriorityWorker::PriorityWorker(Worker & worker, Priority defaultPriority,
+                               Priority levels, AgingInterval agingInterval)
+  : my_worker{&worker}
+  , my_queue{std::make_unique<BucketQueue>(levels, agingInterval)}
+  , my_defaultPriority{defaultPriority}
+  , my_scheduled{0}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+    if((levels == 0) || !(defaultPriority < levels))
+    {
+        throw std::invalid_argument{"Invalid priority levels"};
+    }
+    checkAgingInterval(agingInterval);
 }
 
 /// \cond false
@@ -17,32 +377,134 @@ PriorityWorker::~PriorityWorker() noexcept
 }
 /// \endcond
 
-void PriorityWorker::add(Work work, Priority priority)
+PriorityWorker::Handle PriorityWorker::add(Work work, Priority priority)
 {
-    my_worker.add([w = std::move(work), priority](auto & workQueue) {
-        auto it = std::find_if(
-            std::begin(workQueue), std::end(workQueue),
-            [priority](auto const & p) { return priority < p.priority; });
-        workQueue.emplace(it, PriorityWork{priority, std::move(w)});
-    });
-    my_worker.addDirect([this]() {
-        auto workFn = my_worker.getNextItem();
-        workFn();
-        my_worker.notifyIfEmpty();
-    });
+    auto schedule = false;
+    auto const id =
+        houseguest::synchronize(my_mutex, [this, &work, priority, &schedule]() {
+            if(!my_isAccepting)
+            {
+                throw std::runtime_error{"Not accepting work"};
+            }
+            if(!my_queue->accepts(priority))
+            {
+                throw std::invalid_argument{"Invalid priority"};
+            }
+            auto const ret = my_queue->push(priority, std::move(work));
+            if(my_scheduled < my_queue->size())
+            {
+                // counted now so stop waits for the runNext we're about to
+                // hand off
+                schedule = true;
+                ++my_scheduled;
+                ++my_outstanding;
+            }
+            return ret;
+        });
+    if(schedule)
+    {
+        // Each call to runNext executes whatever has the best Priority at
+        // that point, not necessarily this Work.
+        try
+        {
+            my_worker->add([this]() { runNext(); });
+        }
+        catch(...)
+        {
+            houseguest::synchronize(my_mutex, [this, id]() {
+                // If another runNext already took this Work, whatever it
+                // left behind stays queued until a later add schedules a
+                // runNext for it.
+                my_queue->cancel(id);
+                --my_scheduled;
+                if(--my_outstanding == 0)
+                {
+                    my_isEmpty.notify_all();
+                }
+            });
+            throw;
+        }
+    }
+    return Handle{this, id};
 }
 
 void PriorityWorker::stop()
 {
-    my_worker.stop();
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        if(my_isAccepting)
+        {
+            my_isAccepting = false;
+            my_isEmpty.wait(lock, [this]() { return my_outstanding == 0; });
+            my_isRunning = false;
+        }
+    });
 }
 
 bool PriorityWorker::isAccepting() const noexcept
 {
-    return my_worker.isAccepting();
+    return houseguest::synchronize(my_mutex,
+                                   [this]() { return my_isAccepting; });
 }
 
 bool PriorityWorker::isRunning() const noexcept
 {
-    return my_worker.isRunning();
+    return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
+}
+
+PriorityWorker::Handle::CancelStatus PriorityWorker::cancel(Handle::Id id)
+{
+    return houseguest::synchronize(my_mutex, [this, id]() {
+        // The runNext scheduled for this Work stays queued in the underlying
+        // Worker; add reuses it instead of scheduling another.
+        if(my_queue->cancel(id))
+        {
+            return Handle::CancelStatus::cancelled;
+        }
+        return Handle::CancelStatus::failed;
+    });
+}
+
+bool PriorityWorker::setPriority(Handle::Id id, Priority priority)
+{
+    return houseguest::synchronize(my_mutex, [this, id, priority]() {
+        if(!my_queue->accepts(priority))
+        {
+            throw std::invalid_argument{"Invalid priority"};
+        }
+        return my_queue->reprioritize(id, priority);
+    });
+}
+
+void PriorityWorker::runNext() noexcept
+{
+    auto work = houseguest::synchronize(my_mutex, [this]() {
+        --my_scheduled;
+        return my_queue->pop();
+    });
+    if(work)
+    {
+        work();
+    }
+    houseguest::synchronize(my_mutex, [this]() {
+        if(--my_outstanding == 0)
+        {
+            my_isEmpty.notify_all();
+        }
+    });
+}
+
+PriorityWorker::Handle::Handle(PriorityWorker * const worker, Id id)
+  : my_worker{worker}
+  , my_id{id}
+{
+}
+
+PriorityWorker::Handle::CancelStatus PriorityWorker::Handle::cancel()
+{
+    return my_worker->cancel(my_id);
+}
+
+bool PriorityWorker::Handle::setPriority(Priority priority)
+{
+    return my_worker->setPriority(my_id, priority);
 }
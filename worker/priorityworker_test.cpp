@@ -1,6 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
 #include <future>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <bureaucracy/priorityworker.hpp>
 #include <bureaucracy/threadpool.hpp>
@@ -9,6 +15,7 @@
 
 using bureaucracy::PriorityWorker;
 using bureaucracy::Threadpool;
+using bureaucracy::Worker;
 
 TEST(PriorityWorker, test_ctor) // NOLINT
 {
@@ -85,6 +92,348 @@ TEST(PriorityWorker, test_addPriority) // NOLINT
     ASSERT_EQ(10, value);
 }
 
+namespace
+{
+    // Counts the Work handed to the underlying Worker.
+    class CountingWorker : public Worker
+    {
+    public:
+        explicit CountingWorker(Worker & worker)
+          : my_worker{&worker}
+        {
+        }
+
+        void add(Work work) override
+        {
+            ++added;
+            my_worker->add(std::move(work));
+        }
+
+        void stop() override
+        {
+        }
+
+        bool isAccepting() const noexcept override
+        {
+            return true;
+        }
+
+        bool isRunning() const noexcept override
+        {
+            return true;
+        }
+
+        int added{0};
+
+    private:
+        Worker * const my_worker;
+    };
+
+    // Hold the only thread of tp until the returned promise is set so
+    // everything added in the meantime is queued.
+    void blockPool(Threadpool & tp, std::promise<void> & release)
+    {
+        std::promise<void> blocked;
+        auto released = release.get_future().share();
+        tp.add([released, &blocked]() {
+            blocked.set_value();
+            released.get();
+        });
+        blocked.get_future().get();
+    }
+
+    void checkOrder(PriorityWorker & pw, Threadpool & tp)
+    {
+        std::promise<void> release;
+        blockPool(tp, release);
+
+        // (priority, order within that priority)
+        std::vector<std::pair<PriorityWorker::Priority, int>> executed;
+        for(auto i = 0; i < 4; ++i)
+        {
+            for(PriorityWorker::Priority p = 4; p > 0; --p)
+            {
+                pw.add([&executed, p, i]() { executed.emplace_back(p - 1, i); },
+                       p - 1);
+            }
+        }
+        release.set_value();
+        pw.stop();
+
+        ASSERT_EQ(16, executed.size());
+        ASSERT_EQ(true, std::is_sorted(std::begin(executed),
+                                       std::end(executed)));
+    }
+} // namespace
+
+TEST(PriorityWorker, test_heapOrder) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp};
+
+    checkOrder(pw, tp);
+}
+
+TEST(PriorityWorker, test_bucketOrder) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 4};
+
+    checkOrder(pw, tp);
+}
+
+TEST(PriorityWorker, test_bucketDefault) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 2, 4};
+
+    std::promise<void> release;
+    blockPool(tp, release);
+
+    std::vector<int> executed;
+    pw.add([&executed]() { executed.push_back(3); }, 3);
+    pw.add([&executed]() { executed.push_back(2); });
+    pw.add([&executed]() { executed.push_back(1); }, 1);
+    release.set_value();
+    pw.stop();
+
+    ASSERT_EQ((std::vector<int>{1, 2, 3}), executed);
+}
+
+namespace
+{
+    void checkAging(PriorityWorker & pw, Threadpool & tp)
+    {
+        std::promise<void> release;
+        blockPool(tp, release);
+
+        std::vector<int> executed;
+        pw.add([&executed]() { executed.push_back(0); }, 2);
+        // long enough for the first piece of Work to outrank anything else
+        std::this_thread::sleep_for(std::chrono::milliseconds{20});
+        pw.add([&executed]() { executed.push_back(1); }, 0);
+        pw.add([&executed]() { executed.push_back(2); }, 0);
+        pw.add([&executed]() { executed.push_back(3); }, 1);
+        release.set_value();
+        pw.stop();
+
+        ASSERT_EQ((std::vector<int>{0, 1, 2, 3}), executed);
+    }
+} // namespace
+
+TEST(PriorityWorker, test_heapAging) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, std::chrono::milliseconds{1}};
+
+    checkAging(pw, tp);
+}
+
+TEST(PriorityWorker, test_bucketAging) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 3, std::chrono::milliseconds{1}};
+
+    checkAging(pw, tp);
+}
+
+TEST(PriorityWorker, test_slowAging) // NOLINT
+{
+    // with a long interval aging shouldn't change anything
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, std::chrono::hours{1}};
+
+    checkOrder(pw, tp);
+}
+
+TEST(PriorityWorker, test_agingOverflow) // NOLINT
+{
+    // a large Priority times a large interval doesn't fit in a rank
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, std::chrono::hours{1000000}};
+
+    std::promise<void> release;
+    blockPool(tp, release);
+
+    auto constexpr lowest =
+        std::numeric_limits<PriorityWorker::Priority>::max();
+    std::vector<int> executed;
+    pw.add([&executed]() { executed.push_back(1); }, lowest);
+    pw.add([&executed]() { executed.push_back(0); }, 0);
+    pw.add([&executed]() { executed.push_back(2); }, lowest - 1);
+    release.set_value();
+    pw.stop();
+
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), executed);
+}
+
+TEST(NegativePriorityWorker, test_agingInterval) // NOLINT
+{
+    Threadpool tp{1};
+
+    ASSERT_THROW(PriorityWorker(tp, 0, PriorityWorker::AgingInterval::zero()),
+                 std::invalid_argument);
+    ASSERT_THROW(PriorityWorker(tp, 0, 2, std::chrono::seconds{-1}),
+                 std::invalid_argument);
+}
+
+namespace
+{
+    void checkCancel(PriorityWorker & pw, Threadpool & tp)
+    {
+        std::promise<void> release;
+        blockPool(tp, release);
+
+        std::vector<int> executed;
+        auto handle = pw.add([&executed]() { executed.push_back(0); }, 1);
+        pw.add([&executed]() { executed.push_back(1); }, 1);
+        ASSERT_EQ(PriorityWorker::Handle::CancelStatus::cancelled,
+                  handle.cancel());
+        ASSERT_EQ(PriorityWorker::Handle::CancelStatus::failed,
+                  handle.cancel());
+        ASSERT_EQ(false, handle.setPriority(0));
+        release.set_value();
+        pw.stop();
+
+        ASSERT_EQ((std::vector<int>{1}), executed);
+    }
+
+    void checkSetPriority(PriorityWorker & pw, Threadpool & tp)
+    {
+        std::promise<void> release;
+        blockPool(tp, release);
+
+        std::vector<int> executed;
+        auto promoted = pw.add([&executed]() { executed.push_back(0); }, 2);
+        auto demoted = pw.add([&executed]() { executed.push_back(3); }, 0);
+        pw.add([&executed]() { executed.push_back(1); }, 1);
+        auto moved = pw.add([&executed]() { executed.push_back(2); }, 1);
+        ASSERT_EQ(true, promoted.setPriority(0));
+        ASSERT_EQ(true, demoted.setPriority(2));
+        // moving to the same Priority puts Work at the back of the line
+        ASSERT_EQ(true, moved.setPriority(0));
+        ASSERT_EQ(true, moved.setPriority(1));
+        release.set_value();
+        pw.stop();
+
+        ASSERT_EQ((std::vector<int>{0, 1, 2, 3}), executed);
+        ASSERT_EQ(false, promoted.setPriority(1));
+    }
+} // namespace
+
+TEST(PriorityWorker, test_heapCancel) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp};
+
+    checkCancel(pw, tp);
+}
+
+TEST(PriorityWorker, test_bucketCancel) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 3};
+
+    checkCancel(pw, tp);
+}
+
+TEST(PriorityWorker, test_heapSetPriority) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp};
+
+    checkSetPriority(pw, tp);
+}
+
+TEST(PriorityWorker, test_bucketSetPriority) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 3};
+
+    checkSetPriority(pw, tp);
+}
+
+TEST(PriorityWorker, test_cancelAll) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 3};
+
+    std::promise<void> release;
+    blockPool(tp, release);
+
+    auto hit = false;
+    std::vector<PriorityWorker::Handle> handles;
+    for(auto i = 0; i < 10; ++i)
+    {
+        handles.emplace_back(pw.add([&hit]() { hit = true; }, i % 3));
+    }
+    for(auto & handle : handles)
+    {
+        handle.cancel();
+    }
+    release.set_value();
+    pw.stop();
+
+    ASSERT_EQ(false, hit);
+}
+
+TEST(PriorityWorker, test_cancelReusesQueued) // NOLINT
+{
+    Threadpool tp{1};
+    CountingWorker cw{tp};
+    PriorityWorker pw{cw};
+
+    std::promise<void> release;
+    blockPool(tp, release);
+
+    auto hit = false;
+    for(auto i = 0; i < 10; ++i)
+    {
+        pw.add([&hit]() { hit = true; }, 0).cancel();
+    }
+    // only the first add needed to queue anything
+    ASSERT_EQ(1, cw.added);
+
+    auto value = 0;
+    pw.add([&value]() { ++value; });
+    ASSERT_EQ(1, cw.added);
+    pw.add([&value]() { ++value; });
+    ASSERT_EQ(2, cw.added);
+
+    release.set_value();
+    pw.stop();
+    ASSERT_EQ(false, hit);
+    ASSERT_EQ(2, value);
+}
+
+TEST(NegativePriorityWorker, test_bucketLevels) // NOLINT
+{
+    Threadpool tp{1};
+
+    ASSERT_THROW(PriorityWorker(tp, 0, 0), std::invalid_argument);
+    ASSERT_THROW(PriorityWorker(tp, 4, 4), std::invalid_argument);
+}
+
+TEST(NegativePriorityWorker, test_bucketPriority) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 4};
+
+    ASSERT_THROW(pw.add([]() {}, 4), std::invalid_argument);
+}
+
+TEST(NegativePriorityWorker, test_setInvalidPriority) // NOLINT
+{
+    Threadpool tp{1};
+    PriorityWorker pw{tp, 0, 2};
+
+    std::promise<void> release;
+    blockPool(tp, release);
+    auto handle = pw.add([]() {}, 1);
+    ASSERT_THROW(handle.setPriority(2), std::invalid_argument);
+    release.set_value();
+}
+
 TEST(NegativePriorityWorker, test_addStopped) // NOLINT
 {
     Threadpool tp{4};
@@ -93,3 +442,17 @@ TEST(NegativePriorityWorker, test_addStopped) // NOLINT
     pw.stop();
     ASSERT_THROW(pw.add([]() {}), std::runtime_error);
 }
+
+TEST(NegativePriorityWorker, test_workerStopped) // NOLINT
+{
+    Threadpool tp{4};
+    PriorityWorker pw{tp};
+
+    tp.stop();
+    auto hit = false;
+    ASSERT_THROW(pw.add([&hit]() { hit = true; }, 0), std::runtime_error);
+
+    // the rejected Work was taken back, so stop doesn't wait on it
+    pw.stop();
+    ASSERT_EQ(false, hit);
+}
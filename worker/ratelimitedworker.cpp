@@ -0,0 +1,232 @@
+#include <bureaucracy/ratelimitedworker.hpp>
+
+#include <algorithm>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::RateLimitedWorker;
+
+RateLimitedWorker::RateLimitedWorker(Worker & worker, Timer & timer,
+                                     double rate, std::size_t burst)
+  : my_worker{&worker}
+  , my_timer{&timer}
+  , my_rate{rate}
+  , my_burst{static_cast<double>(burst)}
+  , my_tokens{static_cast<double>(burst)}
+  , my_lastRefill{timer.now()}
+  , my_throttled{Duration::zero()}
+  , my_dropped{0}
+  , my_alarmItem{nullptr, 0}
+  , my_isArmed{false}
+  , my_outstanding{0}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+    if(!(rate > 0))
+    {
+        throw std::invalid_argument{"Invalid rate"};
+    }
+    if(burst == 0)
+    {
+        throw std::invalid_argument{"Invalid burst"};
+    }
+}
+
+/// \cond false
+RateLimitedWorker::~RateLimitedWorker() noexcept
+{
+    RateLimitedWorker::stop();
+}
+/// \endcond
+
+void RateLimitedWorker::add(Work work)
+{
+    auto const ready = houseguest::synchronize(my_mutex, [this, &work]() {
+        if(!my_isAccepting)
+        {
+            throw std::runtime_error{"Not accepting work"};
+        }
+        auto const now = my_timer->now();
+        refill(now);
+        if(my_queue.empty() && !(my_tokens < 1))
+        {
+            my_tokens -= 1;
+            ++my_outstanding;
+            return true;
+        }
+        if(!my_isArmed)
+        {
+            arm(now);
+        }
+        my_queue.emplace_back(Queued{std::move(work), now});
+        return false;
+    });
+    if(ready)
+    {
+        try
+        {
+            dispatch(std::move(work));
+        }
+        catch(...)
+        {
+            finished();
+            throw;
+        }
+    }
+}
+
+void RateLimitedWorker::stop()
+{
+    auto batch = houseguest::synchronize(my_mutex, [this]() {
+        std::vector<Work> ret;
+        if(my_isAccepting)
+        {
+            my_isAccepting = false;
+            if(my_isArmed && (my_timer->cancel(my_alarmItem) ==
+                              Timer::Item::CancelStatus::cancelled))
+            {
+                my_isArmed = false;
+            }
+            auto const now = my_timer->now();
+            for(auto & queued : my_queue)
+            {
+                my_throttled += now - queued.added;
+                ret.emplace_back(std::move(queued.work));
+            }
+            my_queue.clear();
+            my_outstanding += ret.size();
+        }
+        return ret;
+    });
+    release(std::move(batch));
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        if(my_isRunning)
+        {
+            // An alarm that couldn't be cancelled is firing and holds a
+            // pointer to this RateLimitedWorker, so it has to finish too.
+            my_idle.wait(lock, [this]() {
+                return !my_isArmed && (my_outstanding == 0);
+            });
+            my_isRunning = false;
+        }
+    });
+}
+
+bool RateLimitedWorker::isAccepting() const noexcept
+{
+    return houseguest::synchronize(my_mutex,
+                                   [this]() { return my_isAccepting; });
+}
+
+bool RateLimitedWorker::isRunning() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
+}
+
+RateLimitedWorker::Duration RateLimitedWorker::throttledTime() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_throttled; });
+}
+
+std::size_t RateLimitedWorker::dropped() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_dropped; });
+}
+
+void RateLimitedWorker::refill(Timer::Time now) noexcept
+{
+    // should be locked
+    if(my_lastRefill < now)
+    {
+        std::chrono::duration<double> const elapsed = now - my_lastRefill;
+        my_tokens = std::min(my_burst, my_tokens + (elapsed.count() * my_rate));
+        my_lastRefill = now;
+    }
+}
+
+void RateLimitedWorker::arm(Timer::Time now)
+{
+    // should be locked
+    std::chrono::duration<double> const wait{(1 - my_tokens) / my_rate};
+    auto delay = std::chrono::duration_cast<Duration>(wait);
+    if(delay < wait)
+    {
+        // round up so the alarm never fires before a token is ready
+        ++delay;
+    }
+    my_alarmItem = my_timer->add([this]() { fire(); }, now + delay);
+    my_isArmed = true;
+}
+
+void RateLimitedWorker::fire()
+{
+    auto batch = houseguest::synchronize(my_mutex, [this]() {
+        std::vector<Work> ret;
+        auto const now = my_timer->now();
+        refill(now);
+        while(!my_queue.empty() && !(my_tokens < 1))
+        {
+            my_tokens -= 1;
+            my_throttled += now - my_queue.front().added;
+            ret.emplace_back(std::move(my_queue.front().work));
+            my_queue.pop_front();
+        }
+        my_outstanding += ret.size();
+
+        my_isArmed = false;
+        if(!my_queue.empty())
+        {
+            try
+            {
+                arm(now);
+            }
+            catch(std::runtime_error const &)
+            {
+                // the Timer stopped, so nothing else can be released
+                my_dropped += my_queue.size();
+                my_queue.clear();
+            }
+        }
+        my_idle.notify_all();
+        return ret;
+    });
+    release(std::move(batch));
+}
+
+void RateLimitedWorker::dispatch(Work work)
+{
+    my_worker->add([w = std::move(work), this]() {
+        w();
+        finished();
+    });
+}
+
+void RateLimitedWorker::release(std::vector<Work> batch)
+{
+    // Each piece of Work is handed over separately so the underlying Worker
+    // can run them in parallel.
+    for(auto & work : batch)
+    {
+        try
+        {
+            dispatch(std::move(work));
+        }
+        catch(std::runtime_error const &)
+        {
+            // the underlying Worker stopped; there's nowhere to send the Work
+            houseguest::synchronize(my_mutex, [this]() {
+                ++my_dropped;
+                --my_outstanding;
+                my_idle.notify_all();
+            });
+        }
+    }
+}
+
+void RateLimitedWorker::finished() noexcept
+{
+    houseguest::synchronize(my_mutex, [this]() {
+        --my_outstanding;
+        my_idle.notify_all();
+    });
+}
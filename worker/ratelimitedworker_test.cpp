@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+#include <bureaucracy/manualclock.hpp>
+#include <bureaucracy/ratelimitedworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::ManualClock;
+using bureaucracy::RateLimitedWorker;
+using bureaucracy::Threadpool;
+using bureaucracy::Timer;
+using bureaucracy::Worker;
+
+namespace
+{
+    // Executes Work as soon as it's added so tests can check exactly when
+    // the RateLimitedWorker releases it.
+    class InlineWorker : public Worker
+    {
+    public:
+        void add(Work work) override
+        {
+            work();
+        }
+
+        void stop() override
+        {
+        }
+
+        bool isAccepting() const noexcept override
+        {
+            return true;
+        }
+
+        bool isRunning() const noexcept override
+        {
+            return true;
+        }
+    };
+} // namespace
+
+TEST(RateLimitedWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    ASSERT_EQ(true, rlw.isAccepting());
+    ASSERT_EQ(true, rlw.isRunning());
+    ASSERT_EQ(RateLimitedWorker::Duration::zero(), rlw.throttledTime());
+}
+
+TEST(RateLimitedWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    rlw.stop();
+    ASSERT_EQ(false, rlw.isAccepting());
+    ASSERT_EQ(false, rlw.isRunning());
+}
+
+TEST(RateLimitedWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    std::promise<void> hit;
+    rlw.add([&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(RateLimitedWorker, test_burst) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+    InlineWorker iw;
+    RateLimitedWorker rlw{iw, t, 10, 3};
+
+    auto val = 0;
+    for(auto i = 0; i < 5; ++i)
+    {
+        rlw.add([&val]() { ++val; });
+    }
+    // the burst goes straight through
+    ASSERT_EQ(3, val);
+
+    clock.advance(std::chrono::milliseconds{99});
+    ASSERT_EQ(3, val);
+    clock.advance(std::chrono::milliseconds{1});
+    ASSERT_EQ(4, val);
+    clock.advance(std::chrono::milliseconds{100});
+    ASSERT_EQ(5, val);
+
+    // waited 100ms and 200ms
+    ASSERT_EQ(std::chrono::milliseconds{300}, rlw.throttledTime());
+}
+
+TEST(RateLimitedWorker, test_refill) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+    InlineWorker iw;
+    RateLimitedWorker rlw{iw, t, 10, 2};
+
+    auto val = 0;
+    rlw.add([&val]() { ++val; });
+    rlw.add([&val]() { ++val; });
+    ASSERT_EQ(2, val);
+
+    // a long quiet period only refills up to the burst
+    clock.advance(std::chrono::seconds{10});
+    for(auto i = 0; i < 3; ++i)
+    {
+        rlw.add([&val]() { ++val; });
+    }
+    ASSERT_EQ(4, val);
+    clock.advance(std::chrono::milliseconds{100});
+    ASSERT_EQ(5, val);
+}
+
+TEST(RateLimitedWorker, test_order) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+    InlineWorker iw;
+    RateLimitedWorker rlw{iw, t, 1000, 1};
+
+    auto val = 0;
+    for(auto i = 0; i < 100; ++i)
+    {
+        rlw.add([&val, i]() {
+            ASSERT_EQ(i, val);
+            ++val;
+        });
+    }
+    clock.advance(std::chrono::seconds{1});
+    ASSERT_EQ(100, val);
+}
+
+TEST(RateLimitedWorker, test_stopDrains) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 1000, 1};
+
+    std::atomic<int> val{0};
+    for(auto i = 0; i < 20; ++i)
+    {
+        rlw.add([&val]() { ++val; });
+    }
+    rlw.stop();
+    ASSERT_EQ(20, val);
+}
+
+TEST(RateLimitedWorker, test_stopTimerStopped) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+    InlineWorker iw;
+    RateLimitedWorker rlw{iw, t, 10, 1};
+
+    auto val = 0;
+    for(auto i = 0; i < 3; ++i)
+    {
+        rlw.add([&val]() { ++val; });
+    }
+    ASSERT_EQ(1, val);
+
+    // the alarm will never fire, so stop has to flush the queue itself
+    t.stop();
+    rlw.stop();
+    ASSERT_EQ(3, val);
+    ASSERT_EQ(0u, rlw.dropped());
+}
+
+TEST(NegativeRateLimitedWorker, test_invalid) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+
+    ASSERT_THROW(RateLimitedWorker(tp, t, 0, 1), std::invalid_argument);
+    ASSERT_THROW(RateLimitedWorker(tp, t, 10, 0), std::invalid_argument);
+}
+
+TEST(NegativeRateLimitedWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    rlw.stop();
+    ASSERT_THROW(rlw.add([]() {}), std::runtime_error);
+}
+
+TEST(NegativeRateLimitedWorker, test_workerStopped) // NOLINT
+{
+    Threadpool tp{4};
+    tp.stop();
+    Timer t;
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    // Work that doesn't wait for the rate reports the rejection
+    ASSERT_THROW(rlw.add([]() {}), std::runtime_error);
+    rlw.stop();
+    ASSERT_EQ(false, rlw.isRunning());
+}
+
+TEST(NegativeRateLimitedWorker, test_dropped) // NOLINT
+{
+    ManualClock clock;
+    Timer t{clock};
+    Threadpool tp{4};
+    RateLimitedWorker rlw{tp, t, 10, 1};
+
+    std::promise<void> hit;
+    rlw.add([&hit]() { hit.set_value(); });
+    rlw.add([]() {});
+    hit.get_future().get();
+    tp.stop();
+
+    // queued Work has nobody to report to, so it's counted instead
+    clock.advance(std::chrono::milliseconds{100});
+    ASSERT_EQ(1u, rlw.dropped());
+    rlw.stop();
+}
@@ -0,0 +1,155 @@
+#include <bureaucracy/readerwriterworker.hpp>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::ReaderWriterWorker;
+
+ReaderWriterWorker::ReaderWriterWorker(Worker & worker)
+  : my_worker{&worker}
+  , my_sharedRunning{0}
+  , my_exclusiveRunning{false}
+  , my_isAccepting{true}
+  , my_isRunning{true}
+{
+}
+
+/// \cond false
+ReaderWriterWorker::~ReaderWriterWorker() noexcept
+{
+    ReaderWriterWorker::stop();
+}
+/// \endcond
+
+void ReaderWriterWorker::addShared(Work work)
+{
+    enqueue(std::move(work), false);
+}
+
+void ReaderWriterWorker::addExclusive(Work work)
+{
+    enqueue(std::move(work), true);
+}
+
+void ReaderWriterWorker::stop()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        if(my_isAccepting)
+        {
+            my_isAccepting = false;
+            my_isIdle.wait(lock, [this]() { return isIdle(); });
+            my_isRunning = false;
+        }
+    });
+}
+
+bool ReaderWriterWorker::isAccepting() const noexcept
+{
+    return houseguest::synchronize(my_mutex,
+                                   [this]() { return my_isAccepting; });
+}
+
+bool ReaderWriterWorker::isRunning() const noexcept
+{
+    return houseguest::synchronize(my_mutex, [this]() { return my_isRunning; });
+}
+
+void ReaderWriterWorker::enqueue(Work work, bool exclusive)
+{
+    houseguest::synchronize(my_mutex, [this, &work, exclusive]() {
+        if(!my_isAccepting)
+        {
+            throw std::runtime_error{"Not accepting work"};
+        }
+        my_queue.emplace_back(Item{std::move(work), exclusive});
+        try
+        {
+            dispatch();
+        }
+        catch(...)
+        {
+            // the underlying Worker won't take anything else either
+            my_queue.clear();
+            if(isIdle())
+            {
+                my_isIdle.notify_all();
+            }
+            throw;
+        }
+    });
+}
+
+void ReaderWriterWorker::dispatch()
+{
+    // should be locked
+    while(!my_queue.empty() && !my_exclusiveRunning)
+    {
+        auto & next = my_queue.front();
+        auto const exclusive = next.exclusive;
+        if(exclusive)
+        {
+            if(my_sharedRunning != 0)
+            {
+                break;
+            }
+            my_exclusiveRunning = true;
+        }
+        else
+        {
+            ++my_sharedRunning;
+        }
+        try
+        {
+            my_worker->add([w = std::move(next.work), exclusive, this]() {
+                w();
+                finished(exclusive);
+            });
+        }
+        catch(...)
+        {
+            if(exclusive)
+            {
+                my_exclusiveRunning = false;
+            }
+            else
+            {
+                --my_sharedRunning;
+            }
+            throw;
+        }
+        my_queue.pop_front();
+    }
+}
+
+void ReaderWriterWorker::finished(bool exclusive) noexcept
+{
+    houseguest::synchronize(my_mutex, [this, exclusive]() {
+        if(exclusive)
+        {
+            my_exclusiveRunning = false;
+        }
+        else
+        {
+            --my_sharedRunning;
+        }
+        try
+        {
+            dispatch();
+        }
+        catch(...)
+        {
+            // the underlying Worker won't take anything else either
+            my_queue.clear();
+        }
+        if(isIdle())
+        {
+            my_isIdle.notify_all();
+        }
+    });
+}
+
+bool ReaderWriterWorker::isIdle() const noexcept
+{
+    // should be locked
+    return my_queue.empty() && (my_sharedRunning == 0) &&
+           !my_exclusiveRunning;
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <vector>
+
+#include <bureaucracy/readerwriterworker.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::ReaderWriterWorker;
+using bureaucracy::Threadpool;
+
+TEST(ReaderWriterWorker, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    ASSERT_EQ(true, rww.isAccepting());
+    ASSERT_EQ(true, rww.isRunning());
+}
+
+TEST(ReaderWriterWorker, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    rww.stop();
+    ASSERT_EQ(false, rww.isAccepting());
+    ASSERT_EQ(false, rww.isRunning());
+}
+
+TEST(ReaderWriterWorker, test_add) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    std::promise<void> hit;
+    rww.add([&hit]() { hit.set_value(); });
+    hit.get_future().get();
+}
+
+TEST(ReaderWriterWorker, test_sharedInParallel) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    // Each piece of shared Work waits for the other to start, which only
+    // works if they run at the same time.
+    std::promise<void> first;
+    std::promise<void> second;
+    auto firstStarted = first.get_future().share();
+    auto secondStarted = second.get_future().share();
+    std::atomic<int> met{0};
+    rww.addShared([&first, secondStarted, &met]() {
+        first.set_value();
+        if(secondStarted.wait_for(std::chrono::seconds{10}) ==
+           std::future_status::ready)
+        {
+            ++met;
+        }
+    });
+    rww.addShared([&second, firstStarted, &met]() {
+        second.set_value();
+        if(firstStarted.wait_for(std::chrono::seconds{10}) ==
+           std::future_status::ready)
+        {
+            ++met;
+        }
+    });
+    rww.stop();
+    ASSERT_EQ(2, met);
+}
+
+TEST(ReaderWriterWorker, test_exclusiveAlone) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    std::atomic<int> readers{0};
+    std::atomic<int> writers{0};
+    std::atomic<int> violations{0};
+    for(auto i = 0; i < 1000; ++i)
+    {
+        if(i % 10 == 0)
+        {
+            rww.addExclusive([&readers, &writers, &violations]() {
+                if((++writers != 1) || (readers != 0))
+                {
+                    ++violations;
+                }
+                --writers;
+            });
+        }
+        else
+        {
+            rww.addShared([&readers, &writers, &violations]() {
+                ++readers;
+                if(writers != 0)
+                {
+                    ++violations;
+                }
+                --readers;
+            });
+        }
+    }
+    rww.stop();
+    ASSERT_EQ(0, violations);
+}
+
+TEST(ReaderWriterWorker, test_order) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+
+    // Exclusive Work sees everything added before it and nothing after.
+    std::atomic<int> count{0};
+    std::vector<int> seen;
+    for(auto i = 0; i < 10; ++i)
+    {
+        for(auto j = 0; j < 10; ++j)
+        {
+            rww.addShared([&count]() { ++count; });
+        }
+        rww.addExclusive([&count, &seen]() { seen.push_back(count); });
+    }
+    rww.stop();
+
+    ASSERT_EQ((std::vector<int>{10, 20, 30, 40, 50, 60, 70, 80, 90, 100}),
+              seen);
+}
+
+TEST(NegativeReaderWriterWorker, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    ReaderWriterWorker rww{tp};
+    rww.stop();
+
+    ASSERT_THROW(rww.addShared([]() {}), std::runtime_error);
+    ASSERT_THROW(rww.addExclusive([]() {}), std::runtime_error);
+}
@@ -3,7 +3,13 @@
 using bureaucracy::SerialWorker;
 
 SerialWorker::SerialWorker(Worker & worker)
+  : SerialWorker{worker, Budget{0, std::chrono::steady_clock::duration::zero()}}
+{
+}
+
+SerialWorker::SerialWorker(Worker & worker, Budget budget)
   : my_worker{worker}
+  , my_budget{budget}
 {
 }
 
@@ -18,9 +24,9 @@ void SerialWorker::add(Work work)
 {
     my_worker.add([w = std::move(work), this](auto & workQueue) {
         workQueue.emplace_back(std::move(w));
-        if(workQueue.size() == 1)
+        if(my_worker.startDrain())
         {
-            my_worker.addDirect([this]() { my_worker.executeAll(); });
+            my_worker.addDirect([this]() { drain(); });
         }
     });
 }
@@ -39,3 +45,15 @@ bool SerialWorker::isRunning() const noexcept
 {
     return my_worker.isRunning();
 }
+
+void SerialWorker::drain() noexcept
+{
+    if(my_worker.executeAll(my_budget.maxItems, my_budget.timeSlice))
+    {
+        if(!my_worker.requeue([this]() { drain(); }))
+        {
+            // there's nowhere to yield to, so finish up here
+            my_worker.executeAll();
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <future>
+#include <thread>
 
 #include <bureaucracy/serialworker.hpp>
 #include <bureaucracy/threadpool.hpp>
@@ -80,6 +82,116 @@ TEST(SerialWorker, test_sequencing) // NOLINT
     future.get();
 }
 
+TEST(SerialWorker, test_stopDrains) // NOLINT
+{
+    Threadpool tp{4};
+    SerialWorker sw{tp};
+
+    auto val = 0;
+    for(auto i = 0; i < 1000; ++i)
+    {
+        sw.add(buildExpected(val, i));
+    }
+    sw.stop();
+    ASSERT_EQ(1000, val);
+}
+
+TEST(SerialWorker, test_addWhileDraining) // NOLINT
+{
+    Threadpool tp{4};
+    SerialWorker sw{tp};
+
+    auto val = 0;
+    std::promise<void> added;
+    std::promise<void> hit;
+    sw.add([&sw, &val, &added, &hit]() {
+        added.get_future().get();
+        ASSERT_EQ(0, val);
+        ++val;
+        sw.add([&val, &hit]() {
+            ASSERT_EQ(2, val);
+            ++val;
+            hit.set_value();
+        });
+    });
+    sw.add(buildExpected(val, 1));
+    added.set_value();
+
+    hit.get_future().get();
+    ASSERT_EQ(3, val);
+}
+
+TEST(SerialWorker, test_budgetOrder) // NOLINT
+{
+    Threadpool tp{4};
+    SerialWorker sw{tp, SerialWorker::Budget{
+                            2, std::chrono::steady_clock::duration::zero()}};
+
+    auto val = 0;
+    for(auto i = 0; i < 100; ++i)
+    {
+        sw.add(buildExpected(val, i));
+    }
+    sw.stop();
+    ASSERT_EQ(100, val);
+}
+
+TEST(SerialWorker, test_budgetYields) // NOLINT
+{
+    Threadpool tp{1};
+    SerialWorker sw{tp, SerialWorker::Budget{
+                            1, std::chrono::steady_clock::duration::zero()}};
+
+    // Hold the only thread so everything below queues up behind it.
+    std::promise<void> release;
+    std::promise<void> blocked;
+    tp.add([&release, &blocked]() {
+        blocked.set_value();
+        release.get_future().get();
+    });
+    blocked.get_future().get();
+
+    auto val = 0;
+    auto other = -1;
+    sw.add(buildExpected(val, 0));
+    sw.add(buildExpected(val, 1));
+    tp.add([&val, &other]() { other = val; });
+    release.set_value();
+
+    sw.stop();
+    ASSERT_EQ(2, val);
+    // the SerialWorker gave up the thread after one piece of Work
+    ASSERT_EQ(1, other);
+}
+
+TEST(SerialWorker, test_timeSlice) // NOLINT
+{
+    Threadpool tp{1};
+    SerialWorker sw{tp, SerialWorker::Budget{0, std::chrono::milliseconds{1}}};
+
+    std::promise<void> release;
+    std::promise<void> blocked;
+    tp.add([&release, &blocked]() {
+        blocked.set_value();
+        release.get_future().get();
+    });
+    blocked.get_future().get();
+
+    auto val = 0;
+    auto other = -1;
+    sw.add([&val]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        ++val;
+    });
+    sw.add(buildExpected(val, 1));
+    tp.add([&val, &other]() { other = val; });
+    release.set_value();
+
+    sw.stop();
+    ASSERT_EQ(2, val);
+    ASSERT_EQ(1, other);
+}
+
 TEST(NegativeSerialWorker, test_addStopped) // NOLINT
 {
     Threadpool tp{4};
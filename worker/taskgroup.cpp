@@ -0,0 +1,142 @@
+#include <bureaucracy/taskgroup.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+#include <houseguest/synchronize.hpp>
+
+using bureaucracy::TaskGroup;
+
+/// \cond false
+struct TaskGroup::State
+{
+    // Execute the next piece of queued Work, returning false if there isn't
+    // any.
+    bool runNext() noexcept
+    {
+        auto next = houseguest::synchronize(mutex, [this]() {
+            Work ret;
+            if(!work.empty())
+            {
+                ret = std::move(work.front());
+                work.pop_front();
+                ++running;
+            }
+            return ret;
+        });
+        if(!next)
+        {
+            return false;
+        }
+
+        next();
+        houseguest::synchronize(mutex, [this]() {
+            --running;
+            if(isDone())
+            {
+                changed.notify_all();
+            }
+        });
+        return true;
+    }
+
+    bool isDone() const noexcept
+    {
+        // should be locked
+        return work.empty() && (running == 0);
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    std::deque<Work> work;
+    std::size_t running = 0;
+    std::size_t waiting = 0;
+
+    bool isAccepting = true;
+    bool isRunning = true;
+};
+/// \endcond
+
+TaskGroup::TaskGroup(Worker & worker)
+  : my_worker{&worker}
+  , my_state{std::make_shared<State>()}
+{
+}
+
+/// \cond false
+TaskGroup::~TaskGroup() noexcept
+{
+    TaskGroup::stop();
+}
+/// \endcond
+
+void TaskGroup::add(Work work)
+{
+    houseguest::synchronize(my_state->mutex, [this, &work]() {
+        if(!my_state->isAccepting)
+        {
+            throw std::runtime_error{"Not accepting work"};
+        }
+        // The function given to my_worker runs whatever is queued when it's
+        // invoked, which may be nothing if a waiting thread got there first.
+        // It can't run until the lock is released, so there's no harm
+        // scheduling it first.
+        my_worker->add([state = my_state]() { state->runNext(); });
+        my_state->work.emplace_back(std::move(work));
+        if(my_state->waiting != 0)
+        {
+            my_state->changed.notify_one();
+        }
+    });
+}
+
+void TaskGroup::wait()
+{
+    auto & state = *my_state;
+    houseguest::synchronize_unique(state.mutex, [&state](auto lock) {
+        ++state.waiting;
+        while(!state.isDone())
+        {
+            if(state.work.empty())
+            {
+                state.changed.wait(lock);
+            }
+            else
+            {
+                lock.unlock();
+                state.runNext();
+                lock.lock();
+            }
+        }
+        --state.waiting;
+    });
+}
+
+void TaskGroup::stop()
+{
+    auto const stopping = houseguest::synchronize(my_state->mutex, [this]() {
+        auto const ret = my_state->isAccepting;
+        my_state->isAccepting = false;
+        return ret;
+    });
+    if(stopping)
+    {
+        wait();
+        houseguest::synchronize(my_state->mutex,
+                                [this]() { my_state->isRunning = false; });
+    }
+}
+
+bool TaskGroup::isAccepting() const noexcept
+{
+    return houseguest::synchronize(my_state->mutex,
+                                   [this]() { return my_state->isAccepting; });
+}
+
+bool TaskGroup::isRunning() const noexcept
+{
+    return houseguest::synchronize(my_state->mutex,
+                                   [this]() { return my_state->isRunning; });
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+
+#include <bureaucracy/taskgroup.hpp>
+#include <bureaucracy/threadpool.hpp>
+
+using bureaucracy::TaskGroup;
+using bureaucracy::Threadpool;
+
+TEST(TaskGroup, test_ctor) // NOLINT
+{
+    Threadpool tp{4};
+    TaskGroup tg{tp};
+
+    ASSERT_EQ(true, tg.isAccepting());
+    ASSERT_EQ(true, tg.isRunning());
+}
+
+TEST(TaskGroup, test_stop) // NOLINT
+{
+    Threadpool tp{4};
+    TaskGroup tg{tp};
+
+    tg.stop();
+    ASSERT_EQ(false, tg.isAccepting());
+    ASSERT_EQ(false, tg.isRunning());
+}
+
+TEST(TaskGroup, test_wait) // NOLINT
+{
+    Threadpool tp{4};
+    TaskGroup tg{tp};
+
+    std::atomic<int> val{0};
+    for(auto i = 0; i < 100; ++i)
+    {
+        tg.add([&val]() { ++val; });
+    }
+    tg.wait();
+    ASSERT_EQ(100, val);
+
+    // still usable after a wait
+    ASSERT_EQ(true, tg.isAccepting());
+    tg.add([&val]() { ++val; });
+    tg.wait();
+    ASSERT_EQ(101, val);
+}
+
+TEST(TaskGroup, test_helpWhileWaiting) // NOLINT
+{
+    Threadpool tp{1};
+    TaskGroup tg{tp};
+
+    // With the only thread blocked the waiting thread has to do the Work.
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    tp.add([released]() { released.get(); });
+
+    auto val = 0;
+    for(auto i = 0; i < 10; ++i)
+    {
+        tg.add([&val]() { ++val; });
+    }
+    tg.wait();
+    ASSERT_EQ(10, val);
+    release.set_value();
+}
+
+TEST(TaskGroup, test_nested) // NOLINT
+{
+    Threadpool tp{1};
+    TaskGroup outer{tp};
+
+    std::atomic<int> val{0};
+    for(auto i = 0; i < 4; ++i)
+    {
+        outer.add([&tp, &val]() {
+            // waiting on the pool's only thread would deadlock if the inner
+            // Work had to wait for a free thread
+            TaskGroup inner{tp};
+            for(auto j = 0; j < 4; ++j)
+            {
+                inner.add([&val]() { ++val; });
+            }
+            inner.wait();
+        });
+    }
+    outer.wait();
+    ASSERT_EQ(16, val);
+}
+
+TEST(NegativeTaskGroup, test_addStopped) // NOLINT
+{
+    Threadpool tp{4};
+    TaskGroup tg{tp};
+
+    tg.stop();
+    ASSERT_THROW(tg.add([]() {}), std::runtime_error);
+}
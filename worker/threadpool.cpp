@@ -3,8 +3,19 @@
 using bureaucracy::Threadpool;
 
 Threadpool::Threadpool(std::size_t threads)
-  : my_threadpool{threads}
+  : Threadpool{threads, 0, 1}
 {
+}
+
+Threadpool::Threadpool(std::size_t threads, Priority defaultPriority,
+                       Priority lanes)
+  : my_threadpool{threads, lanes}
+  , my_defaultPriority{defaultPriority}
+{
+    if(!(defaultPriority < lanes))
+    {
+        throw std::invalid_argument{"Invalid default priority"};
+    }
     for(auto i = 0u; i < threads; ++i)
     {
         my_threadpool.addThread();
@@ -20,7 +31,23 @@ Threadpool::~Threadpool() noexcept
 
 void Threadpool::add(Work work)
 {
-    my_threadpool.add(std::move(work));
+    my_threadpool.add(std::move(work), my_defaultPriority);
+}
+
+void Threadpool::add(Work work, Priority priority)
+{
+    my_threadpool.add(std::move(work), priority);
+}
+
+void Threadpool::add(Work work, CancellationToken token)
+{
+    add(std::move(work), my_defaultPriority, std::move(token));
+}
+
+void Threadpool::add(Work work, Priority priority, CancellationToken token)
+{
+    my_threadpool.add(withCancellation(std::move(work), std::move(token)),
+                      priority);
 }
 
 void Threadpool::stop()
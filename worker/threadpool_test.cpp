@@ -1,9 +1,11 @@
 #include <gtest/gtest.h>
 
 #include <future>
+#include <vector>
 
 #include <bureaucracy/threadpool.hpp>
 
+using bureaucracy::CancellationSource;
 using bureaucracy::Threadpool;
 
 TEST(Threadpool, test_ctor) // NOLINT
@@ -35,6 +37,76 @@ TEST(Threadpool, test_work) // NOLINT
     ASSERT_EQ(10, result.get());
 }
 
+TEST(Threadpool, test_priorityLanes) // NOLINT
+{
+    Threadpool tp{1, 1, 3};
+
+    // Hold the only thread so everything below is queued.
+    std::promise<void> release;
+    std::promise<void> blocked;
+    tp.add([&release, &blocked]() {
+        blocked.set_value();
+        release.get_future().get();
+    });
+    blocked.get_future().get();
+
+    std::vector<int> executed;
+    tp.add([&executed]() { executed.push_back(4); }, 2);
+    tp.add([&executed]() { executed.push_back(2); });
+    tp.add([&executed]() { executed.push_back(0); }, 0);
+    tp.add([&executed]() { executed.push_back(3); });
+    tp.add([&executed]() { executed.push_back(1); }, 0);
+    release.set_value();
+    tp.stop();
+
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 4}), executed);
+}
+
+TEST(Threadpool, test_cancel) // NOLINT
+{
+    Threadpool tp{1, 1, 2};
+
+    // Hold the only thread so everything below is queued.
+    std::promise<void> release;
+    std::promise<void> blocked;
+    auto released = release.get_future().share();
+    tp.add([released, &blocked]() {
+        blocked.set_value();
+        released.get();
+    });
+    blocked.get_future().get();
+
+    CancellationSource source;
+    std::vector<int> executed;
+    for(auto i = 0; i < 100; ++i)
+    {
+        tp.add([&executed]() { executed.push_back(-1); }, source.token());
+    }
+    tp.add([&executed]() { executed.push_back(1); });
+    tp.add([&executed]() { executed.push_back(-1); }, 0, source.token());
+    tp.add([&executed]() { executed.push_back(0); }, 0);
+    source.cancel();
+
+    // Work added after cancelling is skipped too
+    tp.add([&executed]() { executed.push_back(-1); }, source.token());
+    release.set_value();
+    tp.stop();
+
+    ASSERT_EQ((std::vector<int>{0, 1}), executed);
+}
+
+TEST(NegativeThreadpool, test_invalidLanes) // NOLINT
+{
+    ASSERT_THROW(Threadpool(1, 0, 0), std::invalid_argument);
+    ASSERT_THROW(Threadpool(1, 2, 2), std::invalid_argument);
+}
+
+TEST(NegativeThreadpool, test_invalidPriority) // NOLINT
+{
+    Threadpool tp{1, 0, 2};
+    ASSERT_THROW(tp.add([]() {}, 2), std::invalid_argument);
+}
+
 TEST(NegativeThreadpool, test_invalidThreadCount) // NOLINT
 {
     ASSERT_THROW(Threadpool{0}, std::invalid_argument);
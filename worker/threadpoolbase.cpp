@@ -5,45 +5,24 @@
 #include <houseguest/synchronize.hpp>
 
 using bureaucracy::ThreadpoolBase;
-
-namespace
-{
-    void threadWorker(bool & accepting, std::condition_variable & workReady,
-                      std::mutex & mutex,
-                      std::vector<bureaucracy::Worker::Work> & work)
-    {
-        houseguest::synchronize_unique(
-            mutex, [&accepting, &workReady, &work](auto lock) {
-                while(accepting)
-                {
-                    while(!work.empty())
-                    {
-                        auto nextItem = work.front();
-                        work.erase(std::begin(work));
-                        lock.unlock();
-                        nextItem();
-                        lock.lock();
-                    }
-                    if(accepting)
-                    {
-                        // we may have stopped while calling the work functions,
-                        // check before waiting
-                        workReady.wait(lock);
-                    }
-                }
-            });
-    }
-} // namespace
+using bureaucracy::Worker;
 
 /// \cond false
-ThreadpoolBase::ThreadpoolBase(std::size_t maxThreads)
-  : my_isAccepting{true}
+ThreadpoolBase::ThreadpoolBase(std::size_t maxThreads, std::size_t lanes)
+  : my_lanes(lanes)
+  , my_firstLane{lanes}
+  , my_queued{0}
+  , my_isAccepting{true}
   , my_isRunning{true}
 {
     if(maxThreads == 0)
     {
         throw std::invalid_argument{"Invalid thread count"};
     }
+    if(lanes == 0)
+    {
+        throw std::invalid_argument{"Invalid lane count"};
+    }
     my_threads.reserve(maxThreads);
 }
 
@@ -54,12 +33,18 @@ ThreadpoolBase::~ThreadpoolBase() noexcept
 }
 /// \endcond
 
-void ThreadpoolBase::add(Worker::Work work)
+void ThreadpoolBase::add(Worker::Work work, std::size_t lane)
 {
-    houseguest::synchronize(my_mutex, [this, &work]() {
+    if(!(lane < my_lanes.size()))
+    {
+        throw std::invalid_argument{"Invalid priority"};
+    }
+    houseguest::synchronize(my_mutex, [this, &work, lane]() {
         if(my_isAccepting)
         {
-            my_work.emplace_back(std::move(work));
+            my_lanes[lane].emplace_back(std::move(work));
+            my_firstLane = std::min(my_firstLane, lane);
+            ++my_queued;
             my_workReady.notify_one();
         }
         else
@@ -108,18 +93,58 @@ std::size_t ThreadpoolBase::getAllocatedThreads() const noexcept
                                    [this]() { return my_threads.size(); });
 }
 
+std::size_t ThreadpoolBase::getLanes() const noexcept
+{
+    // my_lanes is never resized, so there's no need to lock
+    return my_lanes.size();
+}
+
 void ThreadpoolBase::addThread()
 {
     // assumes it's safe to add a thread here
     if(my_threads.size() != my_threads.capacity())
     {
-        my_threads.emplace_back(std::thread{[this]() {
-            threadWorker(my_isAccepting, my_workReady, my_mutex, my_work);
-        }});
+        my_threads.emplace_back(std::thread{[this]() { runThread(); }});
     }
     else
     {
         throw std::runtime_error{"threads are at capacity"};
     }
 }
+
+void ThreadpoolBase::runThread()
+{
+    houseguest::synchronize_unique(my_mutex, [this](auto lock) {
+        while(my_isAccepting)
+        {
+            while(my_queued != 0)
+            {
+                auto nextItem = takeNext();
+                lock.unlock();
+                nextItem();
+                lock.lock();
+            }
+            if(my_isAccepting)
+            {
+                // we may have stopped while calling the work functions,
+                // check before waiting
+                my_workReady.wait(lock);
+            }
+        }
+    });
+}
+
+Worker::Work ThreadpoolBase::takeNext()
+{
+    // should be locked, with Work queued
+    while(my_lanes[my_firstLane].empty())
+    {
+        ++my_firstLane;
+    }
+    auto & lane = my_lanes[my_firstLane];
+    auto ret = std::move(lane.front());
+    lane.pop_front();
+    --my_queued;
+    return ret;
+}
 /// \endcond